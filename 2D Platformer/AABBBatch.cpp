@@ -0,0 +1,161 @@
+#include "AABBBatch.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define AABB_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define AABB_BATCH_SSE2
+#endif
+
+// same arithmetic as checkCollision so every path agrees to the bit
+static inline bool overlaps(float x1, float y1, float w1, float h1, float x2, float y2, float w2, float h2) {
+    float distanceX = fabsf(x1 - x2) - ((w1 + w2)/2);
+    float distanceY = fabsf(y1 - y2) - ((h1 + h2)/2);
+    return distanceX < 0 && distanceY < 0;
+}
+
+int overlapBatchScalar(float x, float y, float width, float height,
+                       const float *xs, const float *ys, const float *widths, const float *heights, int count, int *hits) {
+    int hitCount = 0;
+    for(int i = 0; i < count; i++) {
+        if(overlaps(x, y, width, height, xs[i], ys[i], widths[i], heights[i])) {
+            hits[hitCount++] = i;
+        }
+    }
+    return hitCount;
+}
+
+#if defined(AABB_BATCH_AVX2)
+
+#define AABB_LANES 8
+
+// one bit per lane, set where the box in that lane overlaps
+static inline int overlapLanes(__m256 x, __m256 y, __m256 width, __m256 height, __m256 half, __m256 signMask,
+                               const float *xs, const float *ys, const float *widths, const float *heights) {
+    __m256 distanceX = _mm256_sub_ps(_mm256_andnot_ps(signMask, _mm256_sub_ps(x, _mm256_loadu_ps(xs))),
+                                     _mm256_mul_ps(_mm256_add_ps(width, _mm256_loadu_ps(widths)), half));
+    __m256 distanceY = _mm256_sub_ps(_mm256_andnot_ps(signMask, _mm256_sub_ps(y, _mm256_loadu_ps(ys))),
+                                     _mm256_mul_ps(_mm256_add_ps(height, _mm256_loadu_ps(heights)), half));
+    __m256 zero = _mm256_setzero_ps();
+    __m256 hit = _mm256_and_ps(_mm256_cmp_ps(distanceX, zero, _CMP_LT_OQ), _mm256_cmp_ps(distanceY, zero, _CMP_LT_OQ));
+    return _mm256_movemask_ps(hit);
+}
+
+#define AABB_SETUP \
+    __m256 boxX = _mm256_set1_ps(x); \
+    __m256 boxY = _mm256_set1_ps(y); \
+    __m256 boxWidth = _mm256_set1_ps(width); \
+    __m256 boxHeight = _mm256_set1_ps(height); \
+    __m256 half = _mm256_set1_ps(0.5f); \
+    __m256 signMask = _mm256_set1_ps(-0.0f);
+
+#elif defined(AABB_BATCH_SSE2)
+
+#define AABB_LANES 4
+
+static inline int overlapLanes(__m128 x, __m128 y, __m128 width, __m128 height, __m128 half, __m128 signMask,
+                               const float *xs, const float *ys, const float *widths, const float *heights) {
+    __m128 distanceX = _mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(x, _mm_loadu_ps(xs))),
+                                  _mm_mul_ps(_mm_add_ps(width, _mm_loadu_ps(widths)), half));
+    __m128 distanceY = _mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(y, _mm_loadu_ps(ys))),
+                                  _mm_mul_ps(_mm_add_ps(height, _mm_loadu_ps(heights)), half));
+    __m128 zero = _mm_setzero_ps();
+    __m128 hit = _mm_and_ps(_mm_cmplt_ps(distanceX, zero), _mm_cmplt_ps(distanceY, zero));
+    return _mm_movemask_ps(hit);
+}
+
+#define AABB_SETUP \
+    __m128 boxX = _mm_set1_ps(x); \
+    __m128 boxY = _mm_set1_ps(y); \
+    __m128 boxWidth = _mm_set1_ps(width); \
+    __m128 boxHeight = _mm_set1_ps(height); \
+    __m128 half = _mm_set1_ps(0.5f); \
+    __m128 signMask = _mm_set1_ps(-0.0f);
+
+#endif
+
+int overlapBatch(float x, float y, float width, float height,
+                 const float *xs, const float *ys, const float *widths, const float *heights, int count, int *hits) {
+#ifdef AABB_LANES
+    AABB_SETUP
+    int hitCount = 0;
+    int i = 0;
+    for(; i + AABB_LANES <= count; i += AABB_LANES) {
+        int lanes = overlapLanes(boxX, boxY, boxWidth, boxHeight, half, signMask, xs + i, ys + i, widths + i, heights + i);
+        //misses are the common case; skip the compaction entirely
+        while(lanes) {
+            int lane = 0;
+            while(!(lanes & (1 << lane))) { lane++; }
+            hits[hitCount++] = i + lane;
+            lanes &= lanes - 1;
+        }
+    }
+    //leftovers that do not fill a register
+    int tail = overlapBatchScalar(x, y, width, height, xs + i, ys + i, widths + i, heights + i, count - i, hits + hitCount);
+    for(int j = 0; j < tail; j++) {
+        hits[hitCount + j] += i;
+    }
+    return hitCount + tail;
+#else
+    return overlapBatchScalar(x, y, width, height, xs, ys, widths, heights, count, hits);
+#endif
+}
+
+void overlapMask(float x, float y, float width, float height,
+                 const float *xs, const float *ys, const float *widths, const float *heights, int count, uint32_t *mask) {
+    memset(mask, 0, ((count + 31) / 32) * sizeof(uint32_t));
+    int i = 0;
+#ifdef AABB_LANES
+    AABB_SETUP
+    for(; i + AABB_LANES <= count; i += AABB_LANES) {
+        //lanes never straddle a word: 32 is a multiple of both lane counts
+        uint32_t lanes = (uint32_t)overlapLanes(boxX, boxY, boxWidth, boxHeight, half, signMask, xs + i, ys + i, widths + i, heights + i);
+        mask[i / 32] |= lanes << (i % 32);
+    }
+#endif
+    for(; i < count; i++) {
+        if(overlaps(x, y, width, height, xs[i], ys[i], widths[i], heights[i])) {
+            mask[i / 32] |= 1u << (i % 32);
+        }
+    }
+}
+
+int overlapPairs(const float *xsA, const float *ysA, const float *widthsA, const float *heightsA, int countA,
+                 const float *xsB, const float *ysB, const float *widthsB, const float *heightsB, int countB,
+                 int *pairsA, int *pairsB, int maxPairs) {
+    int pairCount = 0;
+    for(int a = 0; a < countA && pairCount < maxPairs; a++) {
+        //write B indices straight into the output, then fill in the A side
+        int room = maxPairs - pairCount;
+        if(room >= countB) {
+            int hits = overlapBatch(xsA[a], ysA[a], widthsA[a], heightsA[a], xsB, ysB, widthsB, heightsB, countB, pairsB + pairCount);
+            for(int j = 0; j < hits; j++) {
+                pairsA[pairCount + j] = a;
+            }
+            pairCount += hits;
+        } else {
+            //not enough room to take a whole row blind; check one by one
+            for(int b = 0; b < countB && pairCount < maxPairs; b++) {
+                if(overlaps(xsA[a], ysA[a], widthsA[a], heightsA[a], xsB[b], ysB[b], widthsB[b], heightsB[b])) {
+                    pairsA[pairCount] = a;
+                    pairsB[pairCount] = b;
+                    pairCount++;
+                }
+            }
+        }
+    }
+    return pairCount;
+}
+
+const char *overlapBatchPath() {
+#if defined(AABB_BATCH_AVX2)
+    return "avx2";
+#elif defined(AABB_BATCH_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
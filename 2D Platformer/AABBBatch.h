@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+// Batch versions of checkCollision: one box (center and size) against count
+// boxes stored as separate x / y / width / height arrays, with the same
+// strict-overlap test, so touching edges do not count.
+//
+// Uses AVX2 when the file is built with -mavx2 (or /arch:AVX2), SSE2 on any
+// other x86/x64 build, and plain C++ everywhere else. All paths give the same
+// answers as checkCollision.
+
+// writes the indices of overlapping boxes to hits in ascending order and
+// returns how many there were; hits needs room for count entries
+int overlapBatch(float x, float y, float width, float height,
+                 const float *xs, const float *ys, const float *widths, const float *heights, int count, int *hits);
+
+// sets bit i of mask (32 boxes per word) when box i overlaps; mask needs
+// (count + 31) / 32 words
+void overlapMask(float x, float y, float width, float height,
+                 const float *xs, const float *ys, const float *widths, const float *heights, int count, uint32_t *mask);
+
+// every overlapping (a, b) pair between two sets, appended to pairsA/pairsB;
+// returns the number of pairs written, at most maxPairs
+int overlapPairs(const float *xsA, const float *ysA, const float *widthsA, const float *heightsA, int countA,
+                 const float *xsB, const float *ysB, const float *widthsB, const float *heightsB, int countB,
+                 int *pairsA, int *pairsB, int maxPairs);
+
+// reference path, kept callable so benchmarks can compare against it
+int overlapBatchScalar(float x, float y, float width, float height,
+                       const float *xs, const float *ys, const float *widths, const float *heights, int count, int *hits);
+
+// "avx2", "sse2" or "scalar"
+const char *overlapBatchPath();
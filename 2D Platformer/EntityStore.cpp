@@ -0,0 +1,138 @@
+#include "EntityStore.h"
+
+#define ENTITY_DEAD_SLOT 0xFFFFFFFFu
+
+EntityStore::EntityStore() {
+
+}
+
+void EntityStore::Reserve(int capacity) {
+    x.reserve(capacity);
+    y.reserve(capacity);
+    previousX.reserve(capacity);
+    previousY.reserve(capacity);
+    velocityX.reserve(capacity);
+    velocityY.reserve(capacity);
+    width.reserve(capacity);
+    height.reserve(capacity);
+    spriteIndex.reserve(capacity);
+    type.reserve(capacity);
+    denseSlots.reserve(capacity);
+    slotIndices.reserve(capacity);
+    generations.reserve(capacity);
+}
+
+void EntityStore::Clear() {
+    // invalidate every outstanding handle, then hand all slots back
+    for(int i = 0; i < Count(); i++) {
+        uint32_t slot = denseSlots[i];
+        slotIndices[slot] = ENTITY_DEAD_SLOT;
+        generations[slot]++;
+        freeSlots.push_back(slot);
+    }
+
+    x.clear();
+    y.clear();
+    previousX.clear();
+    previousY.clear();
+    velocityX.clear();
+    velocityY.clear();
+    width.clear();
+    height.clear();
+    spriteIndex.clear();
+    type.clear();
+    denseSlots.clear();
+}
+
+EntityHandle EntityStore::Spawn(EntityType newType, float newX, float newY, float newWidth, float newHeight, int newSpriteIndex) {
+
+    uint32_t slot;
+    if(!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = (uint32_t)generations.size();
+        generations.push_back(0);
+        slotIndices.push_back(ENTITY_DEAD_SLOT);
+    }
+
+    slotIndices[slot] = (uint32_t)Count();
+    denseSlots.push_back(slot);
+
+    x.push_back(newX);
+    y.push_back(newY);
+    previousX.push_back(newX);
+    previousY.push_back(newY);
+    velocityX.push_back(0.0f);
+    velocityY.push_back(0.0f);
+    width.push_back(newWidth);
+    height.push_back(newHeight);
+    spriteIndex.push_back(newSpriteIndex);
+    type.push_back((unsigned char)newType);
+
+    EntityHandle handle = { slot, generations[slot] };
+    return handle;
+}
+
+void EntityStore::Despawn(EntityHandle handle) {
+    int index = IndexOf(handle);
+    if(index >= 0) {
+        DespawnAt(index);
+    }
+}
+
+void EntityStore::DespawnAt(int index) {
+
+    int last = Count() - 1;
+    uint32_t slot = denseSlots[index];
+
+    //move the last entity into the hole so the arrays stay packed
+    if(index != last) {
+        x[index] = x[last];
+        y[index] = y[last];
+        previousX[index] = previousX[last];
+        previousY[index] = previousY[last];
+        velocityX[index] = velocityX[last];
+        velocityY[index] = velocityY[last];
+        width[index] = width[last];
+        height[index] = height[last];
+        spriteIndex[index] = spriteIndex[last];
+        type[index] = type[last];
+        denseSlots[index] = denseSlots[last];
+        slotIndices[denseSlots[index]] = (uint32_t)index;
+    }
+
+    x.pop_back();
+    y.pop_back();
+    previousX.pop_back();
+    previousY.pop_back();
+    velocityX.pop_back();
+    velocityY.pop_back();
+    width.pop_back();
+    height.pop_back();
+    spriteIndex.pop_back();
+    type.pop_back();
+    denseSlots.pop_back();
+
+    slotIndices[slot] = ENTITY_DEAD_SLOT;
+    generations[slot]++;
+    freeSlots.push_back(slot);
+}
+
+bool EntityStore::IsAlive(EntityHandle handle) const {
+    return IndexOf(handle) >= 0;
+}
+
+int EntityStore::IndexOf(EntityHandle handle) const {
+    if(handle.slot >= generations.size() || generations[handle.slot] != handle.generation) {
+        return -1;
+    }
+    uint32_t index = slotIndices[handle.slot];
+    return index == ENTITY_DEAD_SLOT ? -1 : (int)index;
+}
+
+EntityHandle EntityStore::HandleAt(int index) const {
+    uint32_t slot = denseSlots[index];
+    EntityHandle handle = { slot, generations[slot] };
+    return handle;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+enum EntityType {ENTITY_PLAYER, ENTITY_ENEMY, ENTITY_COIN};
+
+// Refers to an entity for as long as it lives. A despawned entity's slot is
+// reused with a bumped generation, so stale handles stop resolving instead of
+// pointing at whatever was spawned next.
+struct EntityHandle {
+    uint32_t slot;
+    uint32_t generation;
+};
+
+// Entities stored as parallel component arrays instead of one object each.
+// Live entities are packed into [0, Count()) so a pass over positions only
+// touches position memory and never skips dead entries. Despawn swaps the
+// last entity into the hole, which means dense indices move around; hold on
+// to an EntityHandle, not an index, across spawns and despawns.
+class EntityStore {
+    public:
+
+        EntityStore();
+
+        void Reserve(int capacity);
+        void Clear();
+
+        EntityHandle Spawn(EntityType type, float x, float y, float width, float height, int spriteIndex);
+        void Despawn(EntityHandle handle);
+        void DespawnAt(int index);
+
+        bool IsAlive(EntityHandle handle) const;
+        // dense index of a live entity, or -1
+        int IndexOf(EntityHandle handle) const;
+        EntityHandle HandleAt(int index) const;
+
+        int Count() const { return (int)type.size(); }
+
+        // components, indexed densely by [0, Count())
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> previousX;
+        std::vector<float> previousY;
+        std::vector<float> velocityX;
+        std::vector<float> velocityY;
+        std::vector<float> width;
+        std::vector<float> height;
+        std::vector<int> spriteIndex;
+        std::vector<unsigned char> type;
+
+    private:
+
+        // dense index -> slot, and slot -> dense index while the slot is alive
+        std::vector<uint32_t> denseSlots;
+        std::vector<uint32_t> slotIndices;
+        std::vector<uint32_t> generations;
+        std::vector<uint32_t> freeSlots;
+};
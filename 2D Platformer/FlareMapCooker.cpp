@@ -0,0 +1,41 @@
+// Offline cooker: turns a FlareMap text level into the binary blob LevelMap
+// maps at runtime. Build and run it as a separate tool, not part of the game:
+//
+//   c++ -O2 FlareMapCooker.cpp LevelMap.cpp FlareMap.cpp Logger.cpp -o FlareMapCooker
+//   ./FlareMapCooker FinalMap.txt FinalMap.fmap
+
+#include "LevelMap.h"
+#include <cstdio>
+#include <iostream>
+
+int main(int argc, char *argv[]) {
+
+    if(argc != 3) {
+        std::cout << "usage: " << argv[0] << " <map.txt> <map.fmap>\n";
+        return 1;
+    }
+
+    FlareMap map;
+    map.Load(argv[1]);
+    if(map.mapWidth <= 0 || map.mapHeight <= 0) {
+        std::cout << "Unable to load " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::vector<unsigned char> blob;
+    if(!CookFlareMap(map, blob)) {
+        return 1;
+    }
+
+    FILE *outfile = fopen(argv[2], "wb");
+    if(outfile == NULL || fwrite(&blob[0], 1, blob.size(), outfile) != blob.size()) {
+        std::cout << "Unable to write " << argv[2] << "\n";
+        if(outfile) { fclose(outfile); }
+        return 1;
+    }
+    fclose(outfile);
+
+    std::cout << argv[2] << ": " << map.mapWidth << "x" << map.mapHeight << " tiles, "
+              << map.entities.size() << " entities, " << blob.size() << " bytes\n";
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "RenderDevice.h"
+#include <SDL.h>
+#include <cstdio>
+
+GLRenderDevice glRenderDevice;
+
+#ifndef APIENTRY
+    #define APIENTRY
+#endif
+
+// not in every GL header the games build against, so looked up by hand
+typedef void (APIENTRY *DrawArraysInstancedFunction)(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+typedef void (APIENTRY *VertexAttribDivisorFunction)(GLuint index, GLuint divisor);
+
+static DrawArraysInstancedFunction drawArraysInstanced = NULL;
+static VertexAttribDivisorFunction vertexAttribDivisor = NULL;
+
+GLRenderDevice::GLRenderDevice() : allowInstancing(true), instancingChecked(false), instancing(false) {
+
+}
+
+void GLRenderDevice::Clear() {
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void GLRenderDevice::UseProgram(GLuint program) {
+    glUseProgram(program);
+}
+
+void GLRenderDevice::BindTexture(GLuint texture) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLRenderDevice::BindArrayBuffer(GLuint buffer) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+}
+
+void GLRenderDevice::SetAttributeEnabled(GLuint attribute, bool enabled) {
+    if(enabled) {
+        glEnableVertexAttribArray(attribute);
+    } else {
+        glDisableVertexAttribArray(attribute);
+    }
+}
+
+void GLRenderDevice::AttributePointer(GLuint attribute, GLsizei stride, const void *pointer, GLint size) {
+    glVertexAttribPointer(attribute, size, GL_FLOAT, false, stride, pointer);
+}
+
+void GLRenderDevice::UniformMatrix(GLint uniform, const float *matrix) {
+    glUniformMatrix4fv(uniform, 1, GL_FALSE, matrix);
+}
+
+void GLRenderDevice::UniformColor(GLint uniform, float r, float g, float b, float a) {
+    glUniform4f(uniform, r, g, b, a);
+}
+
+GLuint GLRenderDevice::CreateBuffer() {
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    return buffer;
+}
+
+void GLRenderDevice::DeleteBuffers(GLsizei count, const GLuint *buffers) {
+    glDeleteBuffers(count, buffers);
+}
+
+void GLRenderDevice::BufferData(size_t bytes, const void *data) {
+    glBufferData(GL_ARRAY_BUFFER, bytes, data, GL_STATIC_DRAW);
+}
+
+void GLRenderDevice::StreamBufferData(size_t bytes, const void *data) {
+    glBufferData(GL_ARRAY_BUFFER, bytes, data, GL_STREAM_DRAW);
+}
+
+void GLRenderDevice::DrawArrays(GLint first, GLsizei count) {
+    glDrawArrays(GL_TRIANGLES, first, count);
+}
+
+bool GLRenderDevice::SupportsInstancing() {
+    if(instancingChecked) { return instancing; }
+    instancingChecked = true;
+    if(!allowInstancing) { return false; }
+
+    //core since 3.3; older contexts (macOS legacy, some Mesa drivers) may
+    //still have the ARB extension. Some platforms hand out pointers for
+    //anything, so the version or extension has to be there as well.
+    int major = 0, minor = 0;
+    const char *version = (const char *)glGetString(GL_VERSION);
+    if(version) {
+        sscanf(version, "%d.%d", &major, &minor);
+    }
+    if(major > 3 || (major == 3 && minor >= 3)) {
+        drawArraysInstanced = (DrawArraysInstancedFunction)SDL_GL_GetProcAddress("glDrawArraysInstanced");
+        vertexAttribDivisor = (VertexAttribDivisorFunction)SDL_GL_GetProcAddress("glVertexAttribDivisor");
+    }
+    if((!drawArraysInstanced || !vertexAttribDivisor) && SDL_GL_ExtensionSupported("GL_ARB_instanced_arrays")) {
+        drawArraysInstanced = (DrawArraysInstancedFunction)SDL_GL_GetProcAddress("glDrawArraysInstancedARB");
+        vertexAttribDivisor = (VertexAttribDivisorFunction)SDL_GL_GetProcAddress("glVertexAttribDivisorARB");
+    }
+    instancing = drawArraysInstanced && vertexAttribDivisor;
+    return instancing;
+}
+
+void GLRenderDevice::AttributeDivisor(GLuint attribute, GLuint divisor) {
+    vertexAttribDivisor(attribute, divisor);
+}
+
+void GLRenderDevice::DrawArraysInstanced(GLint first, GLsizei count, GLsizei instances) {
+    drawArraysInstanced(GL_TRIANGLES, first, count, instances);
+}
@@ -0,0 +1,266 @@
+#include "GameState.h"
+#include "AABBBatch.h"
+#include "JobSystem.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <cmath>
+#include <cctype>
+
+const char *simSubsystemNames[SUBSYSTEM_COUNT] = { "physics", "collision", "pickups", "entities", "snapshot" };
+
+float lerp(float v0, float v1, float t) {
+    return (1.0-t)*v0 + t*v1;
+}
+
+bool checkCollision(float x1, float y1, float w1, float h1, float x2, float y2, float w2, float h2) {
+
+    float  distanceX = fabsf(x1 - x2) - ((w1 + w2)/2);
+    float  distanceY = fabsf(y1 - y2) - ((h1 + h2)/2);
+
+    if(distanceX < 0 && distanceY < 0) { return true; }
+    else{ return false; }
+}
+
+//Tiled writes both "coin" and "Coin" depending on who placed the object
+static bool sameType(const char *a, const char *b) {
+    while(*a && *b) {
+        if(tolower((unsigned char)*a) != tolower((unsigned char)*b)) { return false; }
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+GameState::GameState() {
+
+    spawnX = 0.5f;
+    spawnY = -1.5f;
+    playerX = spawnX;
+    playerY = spawnY;
+    previousPlayerX = playerX;
+    previousPlayerY = playerY;
+    playerWidth = 0.1f;
+    playerHeight = 0.1f;
+
+    velocityX = 3.0f;
+    velocityY = 0.0f;
+    accelerationX = 2.0f;
+    accelerationY = 2.5f;
+    frictionX = 0.7f;
+    frictionY = 0.7f;
+    gravityY = -20.0f;
+
+    TileContacts noContacts = { false, false, false, false };
+    playerContacts = noContacts;
+    playerFalls = 0;
+
+    keyX = 8.85f;
+    keyY = -0.375f;
+    keyWidth = 0.1f;
+    keyHeight = 0.1f;
+    keyCollected = false;
+
+    coinsCollected = 0;
+    levelBottom = 0.0f;
+}
+
+void GameState::Load(const LevelMap *map, float tileSize) {
+    levelCollision.SetMap(map, tileSize);
+    levelBottom = -map->mapHeight * tileSize;
+
+    entities.Clear();
+    entities.Reserve(map->EntityCount());
+    for(int i = 0; i < map->EntityCount(); i++) {
+        //tile objects are anchored at their bottom left corner, so the sprite sits in the row above
+        float x = (map->EntityX(i) + 0.5f) * tileSize;
+        float y = (map->EntityY(i) - 0.5f) * -tileSize;
+
+        if(sameType(map->EntityType(i), "enemy")) {
+            EntityHandle enemy = entities.Spawn(ENTITY_ENEMY, x, y, tileSize, tileSize, ENEMY_SPRITE);
+            entities.velocityX[entities.IndexOf(enemy)] = -ENEMY_SPEED;
+        }
+        else if(sameType(map->EntityType(i), "coin")) {
+            entities.Spawn(ENTITY_COIN, x, y, tileSize, tileSize, COIN_SPRITE);
+        }
+    }
+}
+
+void GameState::Update(float elapsed, PlayerInput &input) {
+
+    timer.Start();
+
+    previousPlayerX = playerX;
+    previousPlayerY = playerY;
+
+    //jump
+    velocityY += 5.0f * input.jumpPresses;
+    input.jumpPresses = 0;
+
+    velocityY = lerp(velocityY, 0.0f, elapsed * frictionY);
+    velocityY += accelerationY * elapsed;
+    float deltaY = velocityY * elapsed;
+
+    velocityY += gravityY * elapsed; //apply gravity -- constant acceleration
+
+    //move player
+    float deltaX = 0.0f;
+    if(input.left) {
+        if(playerX - playerWidth/2 > -1.777f + 1.777f/2 + 1.35f) {
+            velocityX = lerp(velocityX, 0.0f, elapsed * frictionX);
+            velocityX += accelerationX * elapsed;
+            deltaX -= velocityX * elapsed * 3.0;
+        }
+    }
+    else if(input.right) {
+        velocityX = lerp(velocityX, 0.0f, elapsed * frictionX);
+        velocityX += accelerationX * elapsed;
+        deltaX += velocityX * elapsed * 3.0;
+    }
+    if(input.jumpHeld) {
+        deltaY += elapsed * 1.5;
+    }
+
+    timer.Lap(SUBSYSTEM_PHYSICS);
+
+    //keep player on platforms and out of walls; only the cells the player sweeps through are checked
+    {
+        PROFILE_ZONE("collision");
+        playerContacts = levelCollision.Move(playerX, playerY, playerWidth, playerHeight, deltaX, deltaY);
+        if(playerContacts.bottom || playerContacts.top) {
+            velocityY = 0;
+        }
+        //fell out of the level: start over rather than follow the player into the void
+        if(playerY < levelBottom) {
+            LOG_DEBUG("player fell out of the level at x %.2f, respawning\n", playerX);
+            playerX = spawnX;
+            playerY = spawnY;
+            previousPlayerX = playerX;
+            previousPlayerY = playerY;
+            velocityY = 0.0f;
+            playerFalls++;
+        }
+    }
+    timer.Lap(SUBSYSTEM_COLLISION);
+
+    if(!keyCollected && checkCollision(playerX, playerY, playerWidth, playerHeight, keyX, keyY, keyWidth, keyHeight)) {
+        LOG_DEBUG("key collected\n");
+        keyCollected = true;
+        keyX = -100.0f;
+    }
+    timer.Lap(SUBSYSTEM_PICKUPS);
+
+    UpdateEntities(elapsed);
+    timer.Lap(SUBSYSTEM_ENTITIES);
+}
+
+struct EntityStep {
+    GameState *state;
+    float elapsed;
+};
+
+// movement stage: each range only writes its own entities and the level is read only
+static void moveEntities(void *data, int begin, int end) {
+    EntityStep &step = *(EntityStep*)data;
+    EntityStore &entities = step.state->entities;
+    const TileCollision &levelCollision = step.state->levelCollision;
+
+    for(int i = begin; i < end; i++) {
+        entities.previousX[i] = entities.x[i];
+        entities.previousY[i] = entities.y[i];
+    }
+
+    for(int i = begin; i < end; i++) {
+        if(entities.type[i] != ENTITY_ENEMY) { continue; }
+
+        entities.velocityY[i] += step.state->gravityY * step.elapsed;
+        TileContacts contacts = levelCollision.Move(entities.x[i], entities.y[i], entities.width[i], entities.height[i],
+                                                    entities.velocityX[i] * step.elapsed, entities.velocityY[i] * step.elapsed);
+        if(contacts.bottom || contacts.top) {
+            entities.velocityY[i] = 0.0f;
+        }
+        if(contacts.left || contacts.right) {
+            entities.velocityX[i] = -entities.velocityX[i];
+        }
+    }
+}
+
+// overlap stage: player against a range of entities, vectorized; ranges start on a mask word
+static void overlapPlayer(void *data, int begin, int end) {
+    GameState &state = *(GameState*)data;
+    EntityStore &entities = state.entities;
+    overlapMask(state.playerX, state.playerY, state.playerWidth, state.playerHeight,
+                &entities.x[begin], &entities.y[begin], &entities.width[begin], &entities.height[begin], end - begin,
+                &state.overlapWords[begin / 32]);
+}
+
+void GameState::UpdateEntities(float elapsed) {
+
+    EntityStep step = { this, elapsed };
+    jobs.ParallelFor(moveEntities, &step, entities.Count(), MOVEMENT_GRAIN);
+
+    //walk backwards so despawning (which swaps in the last entity) never skips one
+    for(int i = entities.Count() - 1; i >= 0; i--) {
+        if(entities.type[i] == ENTITY_ENEMY && entities.y[i] < levelBottom) {
+            entities.DespawnAt(i);
+        }
+    }
+
+    //only coins react to the player for now
+    int count = entities.Count();
+    if(count == 0) { return; }
+    overlapWords.resize((count + 31) / 32);
+    jobs.ParallelFor(overlapPlayer, this, count, OVERLAP_GRAIN);
+
+    //despawning from the highest index keeps the lower ones valid
+    for(int word = (int)overlapWords.size() - 1; word >= 0; word--) {
+        uint32_t bits = overlapWords[word];
+        for(int bit = 31; bits; bit--) {
+            if(!(bits & (1u << bit))) { continue; }
+            bits &= ~(1u << bit);
+            int i = word * 32 + bit;
+            if(entities.type[i] == ENTITY_COIN) {
+                coinsCollected++;
+                entities.DespawnAt(i);
+            }
+        }
+    }
+}
+
+struct SnapshotCopy {
+    const EntityStore *entities;
+    RenderSnapshot *snapshot;
+};
+
+// sprite stage: entity i becomes sprite 2 + i
+static void copyEntitySprites(void *data, int begin, int end) {
+    SnapshotCopy &copy = *(SnapshotCopy*)data;
+    const EntityStore &entities = *copy.entities;
+    for(int i = begin; i < end; i++) {
+        SnapshotSprite &sprite = copy.snapshot->sprites[2 + i];
+        sprite.x = entities.x[i];
+        sprite.y = entities.y[i];
+        sprite.previousX = entities.previousX[i];
+        sprite.previousY = entities.previousY[i];
+        sprite.width = entities.width[i];
+        sprite.height = entities.height[i];
+        sprite.spriteIndex = entities.spriteIndex[i];
+    }
+}
+
+void GameState::WriteSnapshot(RenderSnapshot &snapshot) const {
+
+    snapshot.cameraX = playerX;
+    snapshot.cameraY = playerY;
+    snapshot.previousCameraX = previousPlayerX;
+    snapshot.previousCameraY = previousPlayerY;
+    snapshot.coinsCollected = coinsCollected;
+
+    //the key never moves
+    SnapshotSprite player = { playerX, playerY, previousPlayerX, previousPlayerY, playerWidth, playerHeight, PLAYER_SPRITE };
+    SnapshotSprite key = { keyX, keyY, keyX, keyY, keyWidth, keyHeight, KEY_SPRITE };
+    snapshot.sprites.resize(2 + entities.Count());
+    snapshot.sprites[0] = player;
+    snapshot.sprites[1] = key;
+    SnapshotCopy copy = { &entities, &snapshot };
+    jobs.ParallelFor(copyEntitySprites, &copy, entities.Count(), SNAPSHOT_GRAIN);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "LevelMap.h"
+#include "TileCollision.h"
+#include "EntityStore.h"
+#include "SimTimer.h"
+#include <stdint.h>
+#include <vector>
+
+#define FIXED_TIMESTEP 0.0166666f
+#define LEVEL_TILE_SIZE 0.1f
+
+#define ENEMY_SPEED 0.5f
+#define ENEMY_SPRITE 81
+#define COIN_SPRITE 51
+
+// sprite sheet cells; the old DrawSprite divided the row by spriteCountY and
+// wrapped around to these for its 115 and 87
+#define PLAYER_SPRITE 99
+#define KEY_SPRITE 39
+
+// smallest range of entities worth handing to another thread, per stage;
+// the overlap grain has to stay a multiple of 32 (one mask word)
+#define MOVEMENT_GRAIN 64
+#define OVERLAP_GRAIN 1024
+#define SNAPSHOT_GRAIN 1024
+
+// linear interpolation (curve fitting); value changes smoothly
+float lerp(float v0, float v1, float t);
+
+bool checkCollision(float x1, float y1, float w1, float h1, float x2, float y2, float w2, float h2);
+
+// subsystems timed by the headless benchmark
+enum SimSubsystem { SUBSYSTEM_PHYSICS, SUBSYSTEM_COLLISION, SUBSYSTEM_PICKUPS, SUBSYSTEM_ENTITIES, SUBSYSTEM_SNAPSHOT, SUBSYSTEM_COUNT };
+extern const char *simSubsystemNames[SUBSYSTEM_COUNT];
+
+// input for one step; Simulation builds it from its InputBuffer
+struct PlayerInput {
+    bool left;
+    bool right;
+    bool jumpHeld;
+
+    // jump key presses not yet applied; the next Update consumes them
+    int jumpPresses;
+};
+
+// a sprite as of the last two simulation steps, center and size
+struct SnapshotSprite {
+    float x;
+    float y;
+    float previousX;
+    float previousY;
+    float width;
+    float height;
+    int spriteIndex;
+};
+
+// Everything the renderer needs from one simulation step, copied out so
+// drawing never reads the GameState the simulation thread is changing. The
+// camera follows the player.
+struct RenderSnapshot {
+    float cameraX;
+    float cameraY;
+    float previousCameraX;
+    float previousCameraY;
+    // player, key, then enemies and coins
+    std::vector<SnapshotSprite> sprites;
+    int coinsCollected;
+    // when the step was due, SimulationThread::Now time
+    uint64_t time;
+};
+
+// Everything the platformer simulates, kept apart from SDL and GL. Update is
+// only ever called with FIXED_TIMESTEP so the result does not depend on the
+// frame rate; the previous* fields let the renderer blend between steps.
+class GameState {
+    public:
+
+        GameState();
+
+        void Load(const LevelMap *map, float tileSize);
+        void Update(float elapsed, PlayerInput &input);
+
+        // enemies walk and fall, turning around at walls; coins wait to be picked up.
+        // Runs as stages on the job system: movement and the player overlap
+        // test in parallel, despawns and pickups in order afterwards
+        void UpdateEntities(float elapsed);
+
+        // overwrites every field but time; entity sprites are copied in parallel
+        void WriteSnapshot(RenderSnapshot &snapshot) const;
+
+        // where the player starts, and restarts after falling out of the level
+        float spawnX;
+        float spawnY;
+        float playerX;
+        float playerY;
+        float previousPlayerX;
+        float previousPlayerY;
+        float playerWidth;
+        float playerHeight;
+
+        float velocityX;
+        float velocityY;
+        float accelerationX;
+        float accelerationY;
+        float frictionX;
+        float frictionY;
+        float gravityY;
+
+        TileContacts playerContacts;
+        // times the player dropped below the level and was respawned
+        int playerFalls;
+
+        float keyX;
+        float keyY;
+        float keyWidth;
+        float keyHeight;
+        bool keyCollected;
+
+        // map spawned enemies and coins
+        EntityStore entities;
+        int coinsCollected;
+        // entities overlapping the player this step, one bit each
+        std::vector<uint32_t> overlapWords;
+
+        TileCollision levelCollision;
+        float levelBottom;
+
+        SimTimer timer;
+};
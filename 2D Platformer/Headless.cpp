@@ -0,0 +1,215 @@
+#include "Headless.h"
+#include "GameState.h"
+#include "Profiler.h"
+#include "Logger.h"
+#include "AABBBatch.h"
+#include "JobSystem.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cfloat>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+// ticks the spawn check steps before it expects the player to stand
+#define SPAWN_CHECK_TICKS 10
+
+// deterministic input: mostly run right, back off to the left every few
+// seconds and jump at a steady rhythm so collision gets exercised
+static void ScriptInput(int tick, PlayerInput &input) {
+    int phase = tick % 600;
+    input.right = phase < 480;
+    input.left = phase >= 480;
+    input.jumpHeld = (tick % 90) < 12;
+    if(tick % 90 == 0) {
+        input.jumpPresses++;
+    }
+}
+
+// fixed pattern rather than rand() so runs stay comparable
+static void SpawnExtraEntities(GameState &state, const LevelMap &map, int count) {
+    state.entities.Reserve(state.entities.Count() + count);
+    for(int i = 0; i < count; i++) {
+        int gridX = (i * 7919) % map.mapWidth;
+        int gridY = (i * 104729) % map.mapHeight;
+        float x = (gridX + 0.5f) * LEVEL_TILE_SIZE;
+        float y = (gridY + 0.5f) * -LEVEL_TILE_SIZE;
+        if(i % 2 == 0) {
+            EntityHandle enemy = state.entities.Spawn(ENTITY_ENEMY, x, y, LEVEL_TILE_SIZE, LEVEL_TILE_SIZE, ENEMY_SPRITE);
+            state.entities.velocityX[state.entities.IndexOf(enemy)] = (i % 4 == 0) ? ENEMY_SPEED : -ENEMY_SPEED;
+        } else {
+            state.entities.Spawn(ENTITY_COIN, x, y, LEVEL_TILE_SIZE, LEVEL_TILE_SIZE, COIN_SPRITE);
+        }
+    }
+}
+
+// FNV-1a over the bits of every entity position, so runs with different
+// worker counts can be checked for the exact same result
+static uint32_t HashEntities(const EntityStore &entities) {
+    uint32_t hash = 2166136261u;
+    for(int i = 0; i < entities.Count(); i++) {
+        float position[2] = { entities.x[i], entities.y[i] };
+        const unsigned char *bytes = (const unsigned char*)position;
+        for(int b = 0; b < (int)sizeof(position); b++) {
+            hash = (hash ^ bytes[b]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+//text maps are cooked on the fly, anything else is mapped as a cooked blob
+static bool LoadMap(LevelMap &map, const char *mapFile) {
+    size_t length = strlen(mapFile);
+    return (length > 4 && strcmp(mapFile + length - 4, ".txt") == 0) ? map.LoadText(mapFile) : map.LoadCooked(mapFile);
+}
+
+int RunHeadless(int ticks, const char *mapFile, int extraEntities, int workers) {
+
+    LevelMap map;
+    if(!LoadMap(map, mapFile)) {
+        printf("headless: unable to load %s\n", mapFile);
+        return 1;
+    }
+
+    GameState state;
+    state.Load(&map, LEVEL_TILE_SIZE);
+    SpawnExtraEntities(state, map, extraEntities);
+    state.timer.enabled = true;
+    int startEntities = state.entities.Count();
+
+    PlayerInput input = { false, false, false, 0 };
+    //the snapshot is written every step, as on the simulation thread
+    RenderSnapshot snapshot;
+    jobs.Start(workers);
+
+    //log lines from the run are drained in the background, like in the game
+    logStart();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int tick = 0; tick < ticks; tick++) {
+        ScriptInput(tick, input);
+        state.Update(FIXED_TIMESTEP, input);
+        state.WriteSnapshot(snapshot);
+        state.timer.Lap(SUBSYSTEM_SNAPSHOT);
+        profiler.EndFrame();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    logShutdown();
+    jobs.Stop();
+
+    printf("\nheadless: %d ticks on a %dx%d map with %d job workers in %.4f s (%.0f ticks/s)\n", ticks, map.mapWidth, map.mapHeight, workers, seconds, ticks / seconds);
+    for(int i = 0; i < SUBSYSTEM_COUNT; i++) {
+        printf("  %-10s %9.3f ms %9.3f us/tick\n", simSubsystemNames[i], state.timer.seconds[i] * 1000.0, state.timer.seconds[i] * 1000000.0 / ticks);
+    }
+    // final state doubles as a cheap determinism check between runs
+    printf("  player at (%.4f, %.4f)\n", state.playerX, state.playerY);
+    printf("  entities %d -> %d, %d coins collected, positions hash %08x\n", startEntities, state.entities.Count(), state.coinsCollected, HashEntities(state.entities));
+
+    //zones inside the simulation, one frame per tick
+    profiler.Report();
+
+    return 0;
+}
+
+int RunSpawnCheck(const char *mapFile) {
+
+    LevelMap map;
+    if(!LoadMap(map, mapFile)) {
+        printf("spawn check: unable to load %s\n", mapFile);
+        return 1;
+    }
+
+    GameState state;
+    state.Load(&map, LEVEL_TILE_SIZE);
+    PlayerInput none = { false, false, false, 0 };
+
+    //the player's box at the spawn point reaches into the floor row
+    int column, row;
+    worldToTileCoordinates(state.spawnX, state.spawnY + state.playerHeight/4, &column, &row, LEVEL_TILE_SIZE);
+    bool inFloor = state.levelCollision.IsSolid(column, row);
+    float floorTop = -LEVEL_TILE_SIZE * row;
+
+    //the player settles onto the floor, touching it every other tick or so
+    int contactTicks = 0;
+    float lowest = FLT_MAX;
+    for(int tick = 0; tick < SPAWN_CHECK_TICKS; tick++) {
+        state.Update(FIXED_TIMESTEP, none);
+        if(state.playerContacts.bottom) {
+            contactTicks++;
+        }
+        lowest = std::min(lowest, state.playerY - state.playerHeight/2);
+    }
+    bool standing = contactTicks > 0 && lowest > floorTop - 0.001f;
+
+    printf("\nspawn check: player spawned at (%.2f, %.2f) %s tile %d,%d\n", state.spawnX, state.spawnY, inFloor ? "inside" : "outside", column, row);
+    printf("  after %d ticks at (%.4f, %.4f), bottom contact on %d ticks, lowest %.4f against floor top %.4f\n",
+           SPAWN_CHECK_TICKS, state.playerX, state.playerY, contactTicks, lowest, floorTop);
+    printf("  %s\n", inFloor && standing ? "ok" : "FAILED");
+    return inFloor && standing ? 0 : 1;
+}
+
+int RunCollisionBenchmark(int boxes) {
+
+    //fixed LCG so every run tests the same boxes
+    unsigned int seed = 12345;
+    std::vector<float> xs(boxes), ys(boxes), widths(boxes), heights(boxes);
+    for(int i = 0; i < boxes; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        xs[i] = (seed >> 8) / (float)(1 << 24) * 12.8f;
+        seed = seed * 1664525u + 1013904223u;
+        ys[i] = (seed >> 8) / (float)(1 << 24) * -3.2f;
+        widths[i] = LEVEL_TILE_SIZE;
+        heights[i] = LEVEL_TILE_SIZE;
+    }
+
+    std::vector<int> hits(boxes), reference(boxes);
+    int queries = 20000000 / boxes + 1;
+    int hitTotal = 0, referenceTotal = 0;
+    bool agree = true;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int q = 0; q < queries; q++) {
+        referenceTotal += overlapBatchScalar(xs[q % boxes], ys[q % boxes], 0.1f, 0.1f, &xs[0], &ys[0], &widths[0], &heights[0], boxes, &reference[0]);
+    }
+    double scalarSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for(int q = 0; q < queries; q++) {
+        hitTotal += overlapBatch(xs[q % boxes], ys[q % boxes], 0.1f, 0.1f, &xs[0], &ys[0], &widths[0], &heights[0], boxes, &hits[0]);
+    }
+    double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    //spot check the actual indices, not just the totals
+    for(int q = 0; q < 64 && agree; q++) {
+        int a = overlapBatchScalar(xs[q % boxes], ys[q % boxes], 0.1f, 0.1f, &xs[0], &ys[0], &widths[0], &heights[0], boxes, &reference[0]);
+        int b = overlapBatch(xs[q % boxes], ys[q % boxes], 0.1f, 0.1f, &xs[0], &ys[0], &widths[0], &heights[0], boxes, &hits[0]);
+        agree = a == b && std::equal(hits.begin(), hits.begin() + b, reference.begin());
+    }
+    agree = agree && hitTotal == referenceTotal;
+
+    double tests = (double)queries * boxes;
+    printf("\ncollision: %d queries against %d boxes\n", queries, boxes);
+    printf("  scalar     %9.3f ms %7.3f ns/test\n", scalarSeconds * 1000.0, scalarSeconds * 1e9 / tests);
+    printf("  %-10s %9.3f ms %7.3f ns/test\n", overlapBatchPath(), batchSeconds * 1000.0, batchSeconds * 1e9 / tests);
+    printf("  speedup %.2fx, results %s\n", scalarSeconds / batchSeconds, agree ? "match" : "DIFFER");
+
+    return agree ? 0 : 1;
+}
+
+#ifdef HEADLESS_MAIN
+// build without SDL or GL for GPU-less boxes:
+// c++ -DHEADLESS_MAIN Headless.cpp GameState.cpp JobSystem.cpp Profiler.cpp Logger.cpp EntityStore.cpp AABBBatch.cpp TileCollision.cpp LevelMap.cpp FlareMap.cpp
+int main(int argc, char *argv[]) {
+    if(argc > 1 && strcmp(argv[1], "--collision") == 0) {
+        return RunCollisionBenchmark(argc > 2 ? atoi(argv[2]) : 1024);
+    }
+    if(argc > 1 && strcmp(argv[1], "--spawn-check") == 0) {
+        return RunSpawnCheck(argc > 2 ? argv[2] : "FinalMap.txt");
+    }
+    int ticks = argc > 1 ? atoi(argv[1]) : 100000;
+    int extraEntities = argc > 3 ? atoi(argv[3]) : 0;
+    int workers = argc > 4 ? atoi(argv[4]) : 0;
+    return RunHeadless(ticks, argc > 2 ? argv[2] : "FinalMap.txt", extraEntities, workers);
+}
+#endif
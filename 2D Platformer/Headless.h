@@ -0,0 +1,18 @@
+#pragma once
+
+// Runs the simulation for the given number of ticks with scripted input and
+// no window or GL context, then prints simulation ticks per second and the
+// time spent in each subsystem. extraEntities scatters that many more enemies
+// and coins over the level to stress the entity passes; workers sets how many
+// job system threads help the one running the loop. Returns the process exit
+// code.
+int RunHeadless(int ticks, const char *mapFile, int extraEntities = 0, int workers = 0);
+
+// Times overlapBatch against the scalar loop on boxes random boxes, checks
+// that both agree and prints the speedup. Returns the process exit code.
+int RunCollisionBenchmark(int boxes);
+
+// Starts the player where the game does, inside the floor, and steps a few
+// ticks without input; fails unless the player lands on top of the floor
+// rather than falling through it. Returns the process exit code.
+int RunSpawnCheck(const char *mapFile);
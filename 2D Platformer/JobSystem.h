@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+// a Dispatch is cut into at most this many ranges per thread, so a worker
+// that finishes early has something left to steal
+#define JOB_RANGES_PER_THREAD 4
+
+// runs body work for items [begin, end)
+typedef void (*JobFunction)(void *data, int begin, int end);
+
+// Jobs of one Dispatch still to finish. A stage that depends on another
+// waits on the other stage's counter before it is dispatched.
+class JobCounter {
+    public:
+
+        JobCounter() : pending(0) {}
+
+        bool Done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+
+        friend class JobSystem;
+        std::atomic<int> pending;
+};
+
+// Work-stealing job scheduler. Every worker owns a queue and takes jobs from
+// its back; threads that run out steal from the front of someone else's.
+// Threads that are not workers (the simulation thread) share one extra
+// queue, and Wait runs jobs rather than blocking, so the thread that
+// dispatched a stage helps finish it. With no workers every job runs on the
+// waiting thread, in order, which is the serial path.
+//
+// Jobs must only write to their own range of items; anything that has to
+// happen in order (spawning, despawning, totals) belongs after the Wait, on
+// one thread. That keeps results identical whatever the worker count.
+class JobSystem {
+    public:
+
+        JobSystem();
+        ~JobSystem();
+
+        // workers -1 starts one per core besides the calling thread
+        void Start(int workers = -1);
+        void Stop();
+        int WorkerCount() const { return (int)threads.size(); }
+
+        // queues function over [0, count) in ranges whose boundaries are
+        // multiples of grain, and returns straight away
+        void Dispatch(JobFunction function, void *data, int count, int grain, JobCounter &counter);
+        // runs queued jobs until the counter is done
+        void Wait(JobCounter &counter);
+
+        // Dispatch and Wait in one; runs inline when there is only one range
+        // or no workers
+        void ParallelFor(JobFunction function, void *data, int count, int grain);
+
+    private:
+
+        struct Job {
+            JobFunction function;
+            void *data;
+            int begin;
+            int end;
+            JobCounter *counter;
+        };
+
+        struct JobQueue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        bool TakeJob(int queue, Job &job);
+        void Execute(const Job &job);
+        void WorkerLoop(int queue);
+
+        std::vector<std::thread> threads;
+        // queue 0 is shared by threads that are not workers
+        std::vector<JobQueue*> queues;
+
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+        std::atomic<int> queued;
+        bool stopping;
+};
+
+extern JobSystem jobs;
@@ -0,0 +1,225 @@
+#include "LevelMap.h"
+#include "Logger.h"
+#include <cstring>
+#include <map>
+#include <string>
+
+#ifdef _WINDOWS
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static uint32_t AlignUp(uint32_t value) {
+    return (value + 3) & ~3u;
+}
+
+bool CookFlareMap(const FlareMap &map, std::vector<unsigned char> &blob) {
+
+    // intern entity types so each name is stored once
+    std::map<std::string, uint32_t> typeIndices;
+    std::vector<std::string> typeNames;
+    for(int i = 0; i < (int)map.entities.size(); i++) {
+        if(typeIndices.find(map.entities[i].type) == typeIndices.end()) {
+            typeIndices[map.entities[i].type] = (uint32_t)typeNames.size();
+            typeNames.push_back(map.entities[i].type);
+        }
+    }
+
+    CookedMapHeader header;
+    header.magic = COOKED_MAP_MAGIC;
+    header.version = COOKED_MAP_VERSION;
+    header.width = map.mapWidth;
+    header.height = map.mapHeight;
+    header.entityCount = (uint32_t)map.entities.size();
+    header.typeCount = (uint32_t)typeNames.size();
+
+    header.tilesOffset = AlignUp(sizeof(CookedMapHeader));
+    header.entitiesOffset = AlignUp(header.tilesOffset + header.width * header.height * sizeof(uint16_t));
+    header.typeOffsetsOffset = AlignUp(header.entitiesOffset + header.entityCount * sizeof(CookedEntity));
+    header.stringsOffset = AlignUp(header.typeOffsetsOffset + header.typeCount * sizeof(uint32_t));
+
+    uint32_t stringsSize = 0;
+    for(int i = 0; i < (int)typeNames.size(); i++) {
+        stringsSize += (uint32_t)typeNames[i].size() + 1;
+    }
+    header.fileSize = AlignUp(header.stringsOffset + stringsSize + 1);
+
+    blob.assign(header.fileSize, 0);
+    memcpy(&blob[0], &header, sizeof(header));
+
+    uint16_t *tiles = (uint16_t*)&blob[header.tilesOffset];
+    for(int y = 0; y < map.mapHeight; y++) {
+        for(int x = 0; x < map.mapWidth; x++) {
+            if(map.mapData[y][x] > 0xFFFF) {
+                LOG_ERROR("Tile index %u does not fit a cooked map\n", (unsigned)map.mapData[y][x]);
+                return false;
+            }
+            tiles[y * map.mapWidth + x] = (uint16_t)map.mapData[y][x];
+        }
+    }
+
+    CookedEntity *entities = (CookedEntity*)&blob[header.entitiesOffset];
+    for(int i = 0; i < (int)map.entities.size(); i++) {
+        entities[i].type = typeIndices[map.entities[i].type];
+        entities[i].x = map.entities[i].x;
+        entities[i].y = map.entities[i].y;
+    }
+
+    uint32_t *typeOffsets = (uint32_t*)&blob[header.typeOffsetsOffset];
+    char *strings = (char*)&blob[header.stringsOffset];
+    uint32_t stringOffset = 0;
+    for(int i = 0; i < (int)typeNames.size(); i++) {
+        typeOffsets[i] = stringOffset;
+        memcpy(strings + stringOffset, typeNames[i].c_str(), typeNames[i].size() + 1);
+        stringOffset += (uint32_t)typeNames[i].size() + 1;
+    }
+
+    return true;
+}
+
+LevelMap::LevelMap() : mapWidth(0), mapHeight(0), tiles(NULL), entities(NULL), typeOffsets(NULL), strings(NULL),
+    entityCount(0), mapping(NULL), mappingSize(0) {
+
+}
+
+LevelMap::~LevelMap() {
+    Unload();
+}
+
+bool LevelMap::LoadCooked(const char *fileName) {
+
+    Unload();
+
+#ifdef _WINDOWS
+    // no mmap here; one read into a single buffer is still parse free
+    std::ifstream infile(fileName, std::ios::binary);
+    if(infile.fail()) {
+        LOG_ERROR("Unable to open cooked map %s\n", fileName);
+        return false;
+    }
+    ownedBlob.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+    if(ownedBlob.empty() || !Attach(&ownedBlob[0], ownedBlob.size())) {
+        Unload();
+        return false;
+    }
+    return true;
+#else
+    int fd = open(fileName, O_RDONLY);
+    if(fd < 0) {
+        LOG_ERROR("Unable to open cooked map %s\n", fileName);
+        return false;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(CookedMapHeader)) {
+        close(fd);
+        LOG_ERROR("Cooked map %s is truncated\n", fileName);
+        return false;
+    }
+
+    void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive on its own
+    close(fd);
+    if(data == MAP_FAILED) {
+        LOG_ERROR("Unable to map cooked map %s\n", fileName);
+        return false;
+    }
+
+    mapping = data;
+    mappingSize = (size_t)info.st_size;
+
+    if(!Attach((const unsigned char*)data, mappingSize)) {
+        LOG_ERROR("Cooked map %s is invalid or from another version\n", fileName);
+        Unload();
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool LevelMap::LoadText(const char *fileName) {
+
+    Unload();
+
+    FlareMap map;
+    map.Load(fileName);
+
+    std::vector<unsigned char> blob;
+    if(!CookFlareMap(map, blob)) {
+        return false;
+    }
+    ownedBlob.swap(blob);
+
+    if(!Attach(&ownedBlob[0], ownedBlob.size())) {
+        Unload();
+        return false;
+    }
+    return true;
+}
+
+bool LevelMap::Attach(const unsigned char *data, size_t size) {
+
+    if(size < sizeof(CookedMapHeader)) { return false; }
+
+    CookedMapHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    if(header.magic != COOKED_MAP_MAGIC || header.version != COOKED_MAP_VERSION || header.fileSize != size) {
+        return false;
+    }
+
+    // every section has to lie inside the blob, in order, and be aligned
+    uint64_t tilesEnd = (uint64_t)header.tilesOffset + (uint64_t)header.width * header.height * sizeof(uint16_t);
+    uint64_t entitiesEnd = (uint64_t)header.entitiesOffset + (uint64_t)header.entityCount * sizeof(CookedEntity);
+    uint64_t typeOffsetsEnd = (uint64_t)header.typeOffsetsOffset + (uint64_t)header.typeCount * sizeof(uint32_t);
+    if(header.tilesOffset < sizeof(CookedMapHeader) || tilesEnd > header.entitiesOffset ||
+       entitiesEnd > header.typeOffsetsOffset || typeOffsetsEnd > header.stringsOffset || header.stringsOffset >= size) {
+        return false;
+    }
+    if((header.tilesOffset | header.entitiesOffset | header.typeOffsetsOffset | header.stringsOffset) & 3) {
+        return false;
+    }
+    // the string table ends the file and is NUL padded, so every name is terminated
+    if(data[size - 1] != 0) { return false; }
+
+    tiles = (const uint16_t*)(data + header.tilesOffset);
+    entities = (const CookedEntity*)(data + header.entitiesOffset);
+    typeOffsets = (const uint32_t*)(data + header.typeOffsetsOffset);
+    strings = (const char*)(data + header.stringsOffset);
+
+    uint32_t stringsSize = (uint32_t)(size - header.stringsOffset);
+    for(uint32_t i = 0; i < header.typeCount; i++) {
+        if(typeOffsets[i] >= stringsSize) { return false; }
+    }
+    for(uint32_t i = 0; i < header.entityCount; i++) {
+        if(entities[i].type >= header.typeCount) { return false; }
+    }
+
+    mapWidth = (int)header.width;
+    mapHeight = (int)header.height;
+    entityCount = (int)header.entityCount;
+    return true;
+}
+
+void LevelMap::Unload() {
+#ifndef _WINDOWS
+    if(mapping != NULL) {
+        munmap(mapping, mappingSize);
+    }
+#endif
+    mapping = NULL;
+    mappingSize = 0;
+    ownedBlob.clear();
+
+    tiles = NULL;
+    entities = NULL;
+    typeOffsets = NULL;
+    strings = NULL;
+    entityCount = 0;
+    mapWidth = 0;
+    mapHeight = 0;
+}
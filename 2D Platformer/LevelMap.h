@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include "FlareMap.h"
+
+// Cooked level blob, written by FlareMapCooker and mapped straight into memory
+// at runtime. Every section is 4 byte aligned and addressed by offset from the
+// start of the file:
+//
+//   CookedMapHeader
+//   uint16_t tiles[height][width]       tile index, 0 = empty
+//   CookedEntity entities[entityCount]
+//   uint32_t typeOffsets[typeCount]     offsets into the string table
+//   char strings[]                      NUL terminated, interned type names
+#define COOKED_MAP_MAGIC 0x50414d46 // "FMAP"
+#define COOKED_MAP_VERSION 1
+
+struct CookedMapHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t entityCount;
+    uint32_t typeCount;
+    uint32_t tilesOffset;
+    uint32_t entitiesOffset;
+    uint32_t typeOffsetsOffset;
+    uint32_t stringsOffset;
+};
+
+struct CookedEntity {
+    uint32_t type;
+    float x;
+    float y;
+};
+
+// Turns a parsed FlareMap into a cooked blob. Returns false if the map does
+// not fit the format (tile indices above 65535).
+bool CookFlareMap(const FlareMap &map, std::vector<unsigned char> &blob);
+
+// Read-only view of a cooked level. LoadCooked maps the blob from disk and
+// uses it in place; LoadText parses a FlareMap text file and cooks it in
+// memory, which is slower but handy while editing levels.
+class LevelMap {
+    public:
+
+        LevelMap();
+        ~LevelMap();
+
+        bool LoadCooked(const char *fileName);
+        bool LoadText(const char *fileName);
+        void Unload();
+
+        unsigned int TileAt(int x, int y) const { return tiles[y * mapWidth + x]; }
+
+        int EntityCount() const { return entityCount; }
+        const char *EntityType(int index) const { return strings + typeOffsets[entities[index].type]; }
+        float EntityX(int index) const { return entities[index].x; }
+        float EntityY(int index) const { return entities[index].y; }
+
+        int mapWidth;
+        int mapHeight;
+
+    private:
+
+        LevelMap(const LevelMap &);
+        LevelMap &operator=(const LevelMap &);
+
+        bool Attach(const unsigned char *data, size_t size);
+
+        const uint16_t *tiles;
+        const CookedEntity *entities;
+        const uint32_t *typeOffsets;
+        const char *strings;
+        int entityCount;
+
+        // either a file mapping or a blob cooked in memory
+        void *mapping;
+        size_t mappingSize;
+        std::vector<unsigned char> ownedBlob;
+};
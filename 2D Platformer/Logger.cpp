@@ -0,0 +1,135 @@
+#include "Logger.h"
+#include <cstdio>
+#include <cstdarg>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+struct LogRecord {
+    int level;
+    char text[LOG_MESSAGE_SIZE];
+};
+
+// Single producer (the owning thread), single consumer (the drain thread).
+// head and tail only ever grow; the slot is the count modulo the ring size.
+struct LogRing {
+    LogRing() : head(0), tail(0) {}
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    LogRecord records[LOG_RING_SIZE];
+};
+
+static const char *levelPrefixes[] = { "[debug] ", "", "[warn] ", "[error] " };
+
+static std::mutex ringsMutex;
+static std::vector<LogRing*> rings;
+static std::thread drainThread;
+static std::mutex drainMutex;
+static std::condition_variable drainWake;
+static bool stopping = false;
+static std::atomic<bool> running(false);
+static std::atomic<uint64_t> dropped(0);
+
+static thread_local LogRing *threadRing = NULL;
+
+static LogRing *getThreadRing() {
+    //first message from a thread registers its ring; there are only a few
+    //threads, so rings are kept for the life of the process
+    if(!threadRing) {
+        threadRing = new LogRing();
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.push_back(threadRing);
+    }
+    return threadRing;
+}
+
+static void writeRecord(const LogRecord &record) {
+    fputs(levelPrefixes[record.level], stdout);
+    fputs(record.text, stdout);
+}
+
+static void drainRings() {
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    bool wrote = false;
+    for(int i = 0; i < (int)rings.size(); i++) {
+        LogRing *ring = rings[i];
+        uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint32_t head = ring->head.load(std::memory_order_acquire);
+        for(; tail != head; tail++) {
+            writeRecord(ring->records[tail % LOG_RING_SIZE]);
+            wrote = true;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+    if(wrote) {
+        fflush(stdout);
+    }
+}
+
+static void drainLoop() {
+    std::unique_lock<std::mutex> lock(drainMutex);
+    while(!stopping) {
+        drainWake.wait_for(lock, std::chrono::milliseconds(LOG_DRAIN_INTERVAL_MS));
+        lock.unlock();
+        drainRings();
+        lock.lock();
+    }
+}
+
+void logStart() {
+    if(running) { return; }
+    stopping = false;
+    running = true;
+    drainThread = std::thread(drainLoop);
+}
+
+void logShutdown() {
+    if(!running) { return; }
+    {
+        std::lock_guard<std::mutex> lock(drainMutex);
+        stopping = true;
+    }
+    drainWake.notify_one();
+    drainThread.join();
+    running = false;
+
+    //whatever was logged while the drain thread was stopping
+    drainRings();
+    if(dropped > 0) {
+        printf("[warn] %llu log messages were dropped\n", (unsigned long long)dropped.load());
+    }
+}
+
+void logWrite(int level, const char *format, ...) {
+
+    va_list args;
+    va_start(args, format);
+
+    if(!running) {
+        fputs(levelPrefixes[level], stdout);
+        vprintf(format, args);
+        va_end(args);
+        return;
+    }
+
+    LogRing *ring = getThreadRing();
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if(head - ring->tail.load(std::memory_order_acquire) == LOG_RING_SIZE) {
+        dropped++;
+        va_end(args);
+        return;
+    }
+
+    LogRecord &record = ring->records[head % LOG_RING_SIZE];
+    record.level = level;
+    vsnprintf(record.text, LOG_MESSAGE_SIZE, format, args);
+    va_end(args);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+uint64_t logDroppedCount() {
+    return dropped;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+
+// levels below this are compiled out entirely, arguments included;
+// override with -DLOG_MIN_LEVEL=...
+#ifndef LOG_MIN_LEVEL
+    #ifdef NDEBUG
+        #define LOG_MIN_LEVEL LOG_LEVEL_INFO
+    #else
+        #define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+    #endif
+#endif
+
+// longest formatted message, longer ones are cut
+#define LOG_MESSAGE_SIZE 128
+
+// messages each thread can have waiting before new ones are dropped; a power
+// of two so the ring indices stay valid when the counters wrap
+#define LOG_RING_SIZE 256
+
+#define LOG_DRAIN_INTERVAL_MS 10
+
+// Logging that never waits on stdout. A message is formatted straight into a
+// ring owned by the calling thread and a background thread writes the rings
+// out, so a slow terminal or a pipe can not stall the frame. When a ring is
+// full the message is dropped and counted rather than blocking. Before
+// logStart (or after logShutdown) messages are written immediately, which
+// keeps command line tools simple.
+void logStart();
+void logShutdown();
+
+void logWrite(int level, const char *format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+// messages dropped because a ring was full
+uint64_t logDroppedCount();
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+    #define LOG_DEBUG(...) logWrite(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+    #define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+    #define LOG_INFO(...) logWrite(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+    #define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+    #define LOG_WARN(...) logWrite(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+    #define LOG_WARN(...) ((void)0)
+#endif
+
+#define LOG_ERROR(...) logWrite(LOG_LEVEL_ERROR, __VA_ARGS__)
@@ -0,0 +1,231 @@
+#include "Profiler.h"
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+struct TraceEvent {
+    int zone;
+    int thread;
+    uint64_t start;
+    uint64_t duration;
+};
+
+Profiler profiler;
+
+// the zone table is append-only, so lookups never need the lock
+static const char *zoneNames[PROFILER_MAX_ZONES];
+static std::atomic<int> zoneCount(0);
+static std::mutex zoneMutex;
+
+// time charged to each zone in the current frame
+static std::atomic<uint64_t> frameNanoseconds[PROFILER_MAX_ZONES];
+static std::atomic<int> frameHits[PROFILER_MAX_ZONES];
+
+// per zone per frame in milliseconds, negative when the zone did not run
+static float history[PROFILER_MAX_ZONES][PROFILER_HISTORY_FRAMES];
+static int historyFrames = 0;
+static int historyCursor = 0;
+
+static std::atomic<bool> capturing(false);
+static std::mutex captureMutex;
+static std::vector<TraceEvent> events;
+static std::string captureFile;
+static int captureFramesLeft = 0;
+static uint64_t captureDropped = 0;
+
+static uint64_t lastFrameEnd = 0;
+
+static std::atomic<int> threadCount(0);
+static thread_local int threadIndex = -1;
+
+static int currentThread() {
+    if(threadIndex < 0) {
+        threadIndex = threadCount++;
+    }
+    return threadIndex;
+}
+
+Profiler::Profiler() : epoch(std::chrono::steady_clock::now()) {
+    for(int i = 0; i < PROFILER_MAX_ZONES; i++) {
+        frameNanoseconds[i] = 0;
+        frameHits[i] = 0;
+    }
+}
+
+int Profiler::ZoneId(const char *name) {
+    //names are nearly always the same literal, so try the pointer first
+    int count = zoneCount.load(std::memory_order_acquire);
+    for(int i = 0; i < count; i++) {
+        if(zoneNames[i] == name) { return i; }
+    }
+    for(int i = 0; i < count; i++) {
+        if(strcmp(zoneNames[i], name) == 0) { return i; }
+    }
+
+    std::lock_guard<std::mutex> lock(zoneMutex);
+    count = zoneCount.load(std::memory_order_relaxed);
+    for(int i = 0; i < count; i++) {
+        if(strcmp(zoneNames[i], name) == 0) { return i; }
+    }
+    if(count == PROFILER_MAX_ZONES) {
+        return -1;
+    }
+    zoneNames[count] = name;
+    for(int frame = 0; frame < PROFILER_HISTORY_FRAMES; frame++) {
+        history[count][frame] = -1.0f;
+    }
+    zoneCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+void Profiler::Record(int zone, uint64_t startNanoseconds, uint64_t endNanoseconds) {
+
+    uint64_t duration = endNanoseconds - startNanoseconds;
+    frameNanoseconds[zone].fetch_add(duration, std::memory_order_relaxed);
+    frameHits[zone].fetch_add(1, std::memory_order_relaxed);
+
+    if(capturing.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(captureMutex);
+        if(events.size() < events.capacity()) {
+            TraceEvent event = { zone, currentThread(), startNanoseconds, duration };
+            events.push_back(event);
+        } else {
+            captureDropped++;
+        }
+    }
+}
+
+void Profiler::EndFrame() {
+
+    //the whole frame is a zone of its own, end to end
+    uint64_t now = Now();
+    int frameZone = ZoneId("frame");
+    if(lastFrameEnd && frameZone >= 0) {
+        Record(frameZone, lastFrameEnd, now);
+    }
+    lastFrameEnd = now;
+
+    int count = ZoneCount();
+    for(int i = 0; i < count; i++) {
+        uint64_t nanoseconds = frameNanoseconds[i].exchange(0, std::memory_order_relaxed);
+        int hits = frameHits[i].exchange(0, std::memory_order_relaxed);
+        history[i][historyCursor] = hits ? (float)(nanoseconds / 1000000.0) : -1.0f;
+    }
+    historyCursor = (historyCursor + 1) % PROFILER_HISTORY_FRAMES;
+    historyFrames = std::min(historyFrames + 1, PROFILER_HISTORY_FRAMES);
+
+    if(Capturing() && --captureFramesLeft <= 0) {
+        StopCapture();
+    }
+}
+
+bool Profiler::StartCapture(const char *fileName, int frames) {
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if(capturing) {
+        return false;
+    }
+    //reserved up front so recording a zone never allocates
+    events.clear();
+    events.reserve(PROFILER_MAX_EVENTS);
+    captureFile = fileName;
+    captureFramesLeft = frames;
+    captureDropped = 0;
+    capturing = true;
+    return true;
+}
+
+bool Profiler::Capturing() const {
+    return capturing;
+}
+
+static void writeJsonString(FILE *file, const char *text) {
+    fputc('"', file);
+    for(; *text; text++) {
+        if(*text == '"' || *text == '\\') { fputc('\\', file); }
+        fputc(*text, file);
+    }
+    fputc('"', file);
+}
+
+void Profiler::StopCapture() {
+
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if(!capturing) {
+        return;
+    }
+    capturing = false;
+
+    FILE *file = fopen(captureFile.c_str(), "w");
+    if(!file) {
+        printf("Unable to write trace %s\n", captureFile.c_str());
+        return;
+    }
+
+    //complete ("X") events in microseconds, one per recorded zone
+    fputs("{\"traceEvents\":[\n", file);
+    for(int i = 0; i < (int)events.size(); i++) {
+        const TraceEvent &event = events[i];
+        fputs("{\"name\":", file);
+        writeJsonString(file, zoneNames[event.zone]);
+        fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                event.thread, event.start / 1000.0, event.duration / 1000.0, i + 1 < (int)events.size() ? "," : "");
+    }
+    fputs("],\"displayTimeUnit\":\"ms\"}\n", file);
+    fclose(file);
+
+    printf("Wrote %d trace events to %s", (int)events.size(), captureFile.c_str());
+    if(captureDropped) {
+        printf(" (%llu dropped)", (unsigned long long)captureDropped);
+    }
+    printf("\n");
+
+    //give the memory back until the next capture
+    std::vector<TraceEvent>().swap(events);
+}
+
+bool Profiler::Stats(int zone, double &minimum, double &average, double &p99) const {
+
+    float samples[PROFILER_HISTORY_FRAMES];
+    int sampleCount = 0;
+    for(int i = 0; i < historyFrames; i++) {
+        if(history[zone][i] >= 0.0f) {
+            samples[sampleCount++] = history[zone][i];
+        }
+    }
+    if(sampleCount == 0) {
+        return false;
+    }
+
+    std::sort(samples, samples + sampleCount);
+    double total = 0.0;
+    for(int i = 0; i < sampleCount; i++) {
+        total += samples[i];
+    }
+    minimum = samples[0];
+    average = total / sampleCount;
+    //nearest rank
+    p99 = samples[std::max(0, (sampleCount * 99 + 99) / 100 - 1)];
+    return true;
+}
+
+void Profiler::Report(FILE *file) const {
+    fprintf(file, "\nprofile: last %d frames, ms per frame\n", historyFrames);
+    fprintf(file, "  %-12s %9s %9s %9s\n", "zone", "min", "avg", "p99");
+    for(int i = 0; i < ZoneCount(); i++) {
+        double minimum, average, p99;
+        if(Stats(i, minimum, average, p99)) {
+            fprintf(file, "  %-12s %9.3f %9.3f %9.3f\n", zoneNames[i], minimum, average, p99);
+        }
+    }
+}
+
+int Profiler::ZoneCount() const {
+    return zoneCount.load(std::memory_order_acquire);
+}
+
+const char *Profiler::ZoneName(int zone) const {
+    return zoneNames[zone];
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstdio>
+#include <chrono>
+
+// distinct zone names; extra ones are not recorded
+#define PROFILER_MAX_ZONES 32
+
+// frames kept for min / avg / p99
+#define PROFILER_HISTORY_FRAMES 256
+
+// trace events kept during one capture; the rest are dropped
+#define PROFILER_MAX_EVENTS 262144
+
+#define PROFILER_CAPTURE_FRAMES 300
+
+// Wall time per named zone, gathered per frame. Zones are marked with
+// ProfileZone objects (or PROFILE_ZONE for a whole scope) and EndFrame closes
+// the frame, timing it as the "frame" zone. Report prints min / avg / p99 per
+// zone over the last PROFILER_HISTORY_FRAMES frames; nested zones count
+// towards both. During a capture every zone is also kept as a Chrome
+// trace_event and written out as JSON that chrome://tracing and Perfetto
+// open. Zones may be timed on any thread; EndFrame, captures and reports
+// belong to the main loop.
+class Profiler {
+    public:
+
+        Profiler();
+
+        // index for a zone name, registering it the first time; -1 if full
+        int ZoneId(const char *name);
+
+        void Record(int zone, uint64_t startNanoseconds, uint64_t endNanoseconds);
+        void EndFrame();
+
+        // records the next frames and writes them to fileName when done
+        bool StartCapture(const char *fileName, int frames = PROFILER_CAPTURE_FRAMES);
+        void StopCapture();
+        bool Capturing() const;
+
+        // milliseconds over the frames the zone ran in; false if it never ran
+        bool Stats(int zone, double &minimum, double &average, double &p99) const;
+        void Report(FILE *file = stdout) const;
+
+        int ZoneCount() const;
+        const char *ZoneName(int zone) const;
+
+        uint64_t Now() const {
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+        }
+
+    private:
+
+        std::chrono::steady_clock::time_point epoch;
+};
+
+extern Profiler profiler;
+
+#ifdef PROFILER_DISABLED
+
+class ProfileZone {
+    public:
+        ProfileZone(const char *name) {}
+        void End() {}
+};
+
+#else
+
+// Times from construction to End() or destruction, whichever comes first.
+class ProfileZone {
+    public:
+
+        ProfileZone(const char *name) : zone(profiler.ZoneId(name)), start(profiler.Now()) {}
+        ~ProfileZone() { End(); }
+
+        void End() {
+            if(zone < 0) { return; }
+            profiler.Record(zone, start, profiler.Now());
+            zone = -1;
+        }
+
+    private:
+
+        int zone;
+        uint64_t start;
+};
+
+#endif
+
+#define PROFILE_ZONE_JOIN(a, b) a##b
+#define PROFILE_ZONE_NAME(line) PROFILE_ZONE_JOIN(profileZone, line)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_NAME(__LINE__)(name)
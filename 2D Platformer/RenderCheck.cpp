@@ -0,0 +1,264 @@
+#include "RenderCheck.h"
+#include "RenderDevice.h"
+#include "RenderState.h"
+#include "WorldRenderer.h"
+#include "SpriteInstancer.h"
+#include "GameState.h"
+#include "Simulation.h"
+#include "LevelMap.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+
+// stands in for a linked program; only the ids matter to the recording
+static void FakeProgram(ShaderProgram &program, GLuint id, GLint texCoordAttribute) {
+    program.programID = id;
+    program.modelMatrixUniform = id * 8 + 0;
+    program.viewMatrixUniform = id * 8 + 1;
+    program.projectionMatrixUniform = id * 8 + 2;
+    program.colorUniform = id * 8 + 3;
+    program.positionAttribute = 0;
+    program.texCoordAttribute = texCoordAttribute;
+}
+
+// draws the level frames times through one sprite path; returns how many
+// frames went over budget or drew no tiles, plus how often the player fell
+static int CheckPath(const LevelMap &map, bool instancing, int frames, int maxDrawCalls, int maxStateChanges, FILE *dump) {
+
+    RecordingRenderDevice device(instancing);
+    RenderDevice *previousDevice = renderState.Device();
+    renderState.SetDevice(&device);
+
+    ShaderProgram program;
+    ShaderProgram texturedProgram;
+    ShaderProgram instancedProgram;
+    FakeProgram(program, 1, -1);
+    FakeProgram(texturedProgram, 2, 1);
+    FakeProgram(instancedProgram, 3, 1);
+    InstanceAttributes instanceAttributes = { 2, 3, 4 };
+    GLuint sheetTexture = 1;
+
+    glm::mat4 projectionMatrix = glm::ortho(-1.777f, 1.777f, -1.0f, 1.0f, -1.0f, 1.0f);
+
+    TileMapRenderer tileMapRenderer;
+    tileMapRenderer.SetMap(&map, LEVEL_TILE_SIZE, 16, 8);
+    SpriteInstancer sprites;
+    sprites.Setup(&instancedProgram, instanceAttributes, &texturedProgram);
+
+    GameState state;
+    state.Load(&map, LEVEL_TILE_SIZE);
+    PlayerInput input = { false, true, false, 0 };
+    RenderSnapshot snapshot;
+
+    const char *path = sprites.Instancing() ? "instanced" : "batched";
+    int worstDrawCalls = 0, worstStateChanges = 0, failedFrames = 0, emptyFrames = 0, falls = 0;
+    long totalDrawCalls = 0, totalStateChanges = 0, totalVertices = 0;
+    for(int frame = 0; frame < frames; frame++) {
+        state.Update(FIXED_TIMESTEP, input);
+        state.WriteSnapshot(snapshot);
+
+        device.Reset();
+        DrawWorld(snapshot, 1.0f, program, texturedProgram, sheetTexture, projectionMatrix, tileMapRenderer, sprites);
+
+        totalDrawCalls += device.drawCalls;
+        totalStateChanges += device.stateChanges;
+        totalVertices += device.vertices;
+
+        //a frame without tiles checks nothing but the player; the camera has
+        //left the level
+        if(tileMapRenderer.chunksDrawnLastDraw == 0) {
+            if(emptyFrames == 0) {
+                printf("render check: %s frame %d draws no tiles\n", path, frame);
+            }
+            emptyFrames++;
+        }
+        //running right from the spawn never drops off the level, so a fall
+        //means the collision let the player through the floor
+        if(state.playerFalls > falls) {
+            if(falls == 0) {
+                printf("render check: %s frame %d, the player fell out of the level\n", path, frame);
+            }
+            falls = state.playerFalls;
+        }
+
+        //the first frame sets everything up from scratch, so it gets a pass
+        if(frame == 0) { continue; }
+        worstDrawCalls = std::max(worstDrawCalls, device.drawCalls);
+        worstStateChanges = std::max(worstStateChanges, device.stateChanges);
+        if(device.drawCalls > maxDrawCalls || device.stateChanges > maxStateChanges) {
+            if(failedFrames == 0) {
+                printf("render check: %s frame %d has %d draw calls and %d state changes\n", path, frame, device.drawCalls, device.stateChanges);
+            }
+            failedFrames++;
+        }
+    }
+
+    if(dump) {
+        fprintf(dump, "# %s, frame %d\n", path, frames - 1);
+        device.Write(dump);
+    }
+
+    tileMapRenderer.Cleanup();
+    sprites.Cleanup();
+    renderState.SetDevice(previousDevice);
+
+    printf("  %-10s %.1f draw calls, %.1f state changes, %.0f vertices per frame\n",
+           path, (double)totalDrawCalls / frames, (double)totalStateChanges / frames, (double)totalVertices / frames);
+    printf("  %-10s worst %d draw calls, %d state changes%s\n", "", worstDrawCalls, worstStateChanges, failedFrames ? ", OVER BUDGET" : "");
+    if(emptyFrames) {
+        printf("  %-10s %d frames drew no tiles\n", "", emptyFrames);
+    }
+    if(falls) {
+        printf("  %-10s the player fell out of the level %d times\n", "", falls);
+    }
+
+    return failedFrames + emptyFrames + falls;
+}
+
+int RunRenderCheck(const char *mapFile, int frames, int maxDrawCalls, int maxStateChanges, const char *dumpFile) {
+
+    LevelMap map;
+    size_t length = strlen(mapFile);
+    bool loaded = (length > 4 && strcmp(mapFile + length - 4, ".txt") == 0) ? map.LoadText(mapFile) : map.LoadCooked(mapFile);
+    if(!loaded) {
+        printf("render check: unable to load %s\n", mapFile);
+        return 1;
+    }
+
+    FILE *dump = NULL;
+    if(dumpFile) {
+        dump = fopen(dumpFile, "w");
+        if(!dump) {
+            printf("render check: unable to write %s\n", dumpFile);
+        }
+    }
+
+    printf("\nrender check: %d frames of %s, budget %d draw calls and %d state changes\n", frames, mapFile, maxDrawCalls, maxStateChanges);
+    //both sprite paths, since players without instancing get the batch
+    int failedFrames = CheckPath(map, true, frames, maxDrawCalls, maxStateChanges, dump);
+    failedFrames += CheckPath(map, false, frames, maxDrawCalls, maxStateChanges, dump);
+
+    if(dump) {
+        fclose(dump);
+    }
+    printf("  %s\n", failedFrames ? "FAILED" : "within budget");
+
+    return failedFrames ? 1 : 0;
+}
+
+int RunPipelineBenchmark(const char *mapFile, int steps) {
+
+    LevelMap map;
+    size_t length = strlen(mapFile);
+    bool loaded = (length > 4 && strcmp(mapFile + length - 4, ".txt") == 0) ? map.LoadText(mapFile) : map.LoadCooked(mapFile);
+    if(!loaded) {
+        printf("pipeline: unable to load %s\n", mapFile);
+        return 1;
+    }
+
+    RecordingRenderDevice device;
+    RenderDevice *previousDevice = renderState.Device();
+    renderState.SetDevice(&device);
+
+    ShaderProgram program;
+    ShaderProgram texturedProgram;
+    ShaderProgram instancedProgram;
+    FakeProgram(program, 1, -1);
+    FakeProgram(texturedProgram, 2, 1);
+    FakeProgram(instancedProgram, 3, 1);
+    InstanceAttributes instanceAttributes = { 2, 3, 4 };
+    glm::mat4 projectionMatrix = glm::ortho(-1.777f, 1.777f, -1.0f, 1.0f, -1.0f, 1.0f);
+
+    TileMapRenderer tileMapRenderer;
+    tileMapRenderer.SetMap(&map, LEVEL_TILE_SIZE, 16, 8);
+    SpriteInstancer sprites;
+    sprites.Setup(&instancedProgram, instanceAttributes, &texturedProgram);
+
+    //one thread: step, snapshot and draw, one after the other
+    GameState serialState;
+    serialState.Load(&map, LEVEL_TILE_SIZE);
+    PlayerInput input = { false, true, false, 0 };
+    RenderSnapshot snapshot;
+    //frames without tiles would time drawing next to nothing, and the player
+    //falling out of the level would leave most of it off screen
+    int serialEmptyFrames = 0;
+    uint64_t start = SimulationThread::Now();
+    for(int step = 0; step < steps; step++) {
+        serialState.Update(FIXED_TIMESTEP, input);
+        serialState.WriteSnapshot(snapshot);
+        device.Reset();
+        DrawWorld(snapshot, 1.0f, program, texturedProgram, 1, projectionMatrix, tileMapRenderer, sprites);
+        if(tileMapRenderer.chunksDrawnLastDraw == 0) {
+            serialEmptyFrames++;
+        }
+    }
+    double serialSeconds = (SimulationThread::Now() - start) / 1000000000.0;
+
+    //two threads doing the same work: the simulation runs flat out while this
+    //one draws as many frames, each from whatever snapshot is newest
+    GameState threadedState;
+    threadedState.Load(&map, LEVEL_TILE_SIZE);
+    Simulation simulation(threadedState);
+    simulation.inputs.Record(ACTION_RIGHT, true, SimulationThread::Now());
+    int freshFrames = 0;
+    int threadedEmptyFrames = 0;
+    start = SimulationThread::Now();
+    simulation.Begin(0.0, steps);
+    for(int frame = 0; frame < steps; frame++) {
+        if(simulation.snapshots.Acquire()) {
+            freshFrames++;
+        }
+        device.Reset();
+        DrawWorld(simulation.snapshots.ReadSlot(), 1.0f, program, texturedProgram, 1, projectionMatrix, tileMapRenderer, sprites);
+        if(tileMapRenderer.chunksDrawnLastDraw == 0) {
+            threadedEmptyFrames++;
+        }
+    }
+    while(simulation.Running()) {
+        std::this_thread::yield();
+    }
+    double threadedSeconds = (SimulationThread::Now() - start) / 1000000000.0;
+    simulation.Stop();
+
+    tileMapRenderer.Cleanup();
+    sprites.Cleanup();
+    renderState.SetDevice(previousDevice);
+
+    printf("\npipeline: %d steps of %s\n", steps, mapFile);
+    printf("  serial     %9.3f ms %9.0f steps and frames/s\n", serialSeconds * 1000.0, steps / serialSeconds);
+    printf("  threaded   %9.3f ms %9.0f steps and frames/s, %d frames had a new snapshot\n",
+           threadedSeconds * 1000.0, steps / threadedSeconds, freshFrames);
+    printf("  speedup %.2fx on %u hardware threads\n", serialSeconds / threadedSeconds, std::thread::hardware_concurrency());
+    if(serialEmptyFrames || threadedEmptyFrames) {
+        printf("  %d serial and %d threaded frames drew no tiles, FAILED\n", serialEmptyFrames, threadedEmptyFrames);
+        return 1;
+    }
+    //a respawn brings the camera back, so a fall would not show up above
+    if(serialState.playerFalls || threadedState.playerFalls) {
+        printf("  the player fell out of the level %d times serial and %d threaded, FAILED\n", serialState.playerFalls, threadedState.playerFalls);
+        return 1;
+    }
+
+    return 0;
+}
+
+#ifdef RENDER_CHECK_MAIN
+// needs the GL and SDL headers but no GPU, window or SDL libraries; see README
+int main(int argc, char *argv[]) {
+    if(argc > 2 && strcmp(argv[1], "--pipeline") == 0) {
+        return RunPipelineBenchmark(argv[2], argc > 3 ? atoi(argv[3]) : 100000);
+    }
+    if(argc < 2) {
+        printf("usage: %s map [frames] [max draw calls] [max state changes] [dump file]\n", argv[0]);
+        printf("       %s --pipeline map [steps]\n", argv[0]);
+        return 1;
+    }
+    return RunRenderCheck(argv[1], argc > 2 ? atoi(argv[2]) : 600,
+                          argc > 3 ? atoi(argv[3]) : RENDER_CHECK_MAX_DRAW_CALLS,
+                          argc > 4 ? atoi(argv[4]) : RENDER_CHECK_MAX_STATE_CHANGES,
+                          argc > 5 ? argv[5] : NULL);
+}
+#endif
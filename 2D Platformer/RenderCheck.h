@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+
+// per-frame budgets for the level draw, a little above what it takes today
+#define RENDER_CHECK_MAX_DRAW_CALLS 8
+#define RENDER_CHECK_MAX_STATE_CHANGES 24
+
+// Draws frames of the level into a RecordingRenderDevice with the player
+// running right from where the game spawns them, so no window, GL context or
+// GPU is needed, once with instanced sprites and once with the batched
+// fallback. Prints draw calls, vertices and state changes per frame and fails
+// if the player falls out of the level, any frame draws no tiles or any frame
+// after the first goes over either budget on either path. dumpFile, if given,
+// gets the commands of the last frame of each. Returns the process exit code.
+int RunRenderCheck(const char *mapFile, int frames, int maxDrawCalls = RENDER_CHECK_MAX_DRAW_CALLS,
+                   int maxStateChanges = RENDER_CHECK_MAX_STATE_CHANGES, const char *dumpFile = NULL);
+
+// Steps the simulation and draws a frame per step into a RecordingRenderDevice
+// on one thread, then does the same amount of work with the simulation on its
+// own thread and this one drawing the newest snapshot, and prints the rate of
+// both. The gain needs a second core. Fails if any frame of either run draws
+// no tiles or the player falls out of the level, since the times would then
+// leave the level out. Returns the process exit code.
+int RunPipelineBenchmark(const char *mapFile, int steps);
@@ -0,0 +1,150 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+#include <stddef.h>
+#include <cstdio>
+#include <vector>
+
+// The draw-time GL calls the games make, behind one interface so a frame can
+// be sent to the GPU or just written down. RenderState owns the current
+// device and all drawing goes through it; texture creation and uploads at
+// load time still talk to GL directly.
+class RenderDevice {
+    public:
+
+        virtual ~RenderDevice() {}
+
+        virtual void Clear() = 0;
+        virtual void UseProgram(GLuint program) = 0;
+        virtual void BindTexture(GLuint texture) = 0;
+        virtual void BindArrayBuffer(GLuint buffer) = 0;
+        virtual void SetAttributeEnabled(GLuint attribute, bool enabled) = 0;
+        // size floats per vertex; pointer is an offset when a buffer is bound
+        virtual void AttributePointer(GLuint attribute, GLsizei stride, const void *pointer, GLint size) = 0;
+        virtual void UniformMatrix(GLint uniform, const float *matrix) = 0;
+        virtual void UniformColor(GLint uniform, float r, float g, float b, float a) = 0;
+        virtual GLuint CreateBuffer() = 0;
+        virtual void DeleteBuffers(GLsizei count, const GLuint *buffers) = 0;
+        // static data for the bound array buffer
+        virtual void BufferData(size_t bytes, const void *data) = 0;
+        // data for the bound array buffer that is replaced every frame
+        virtual void StreamBufferData(size_t bytes, const void *data) = 0;
+        virtual void DrawArrays(GLint first, GLsizei count) = 0;
+
+        // instanced drawing (GL 3.3 or ARB_instanced_arrays); the two calls
+        // below may only be made when this returns true
+        virtual bool SupportsInstancing() = 0;
+        // 0 advances the attribute per vertex, 1 per instance
+        virtual void AttributeDivisor(GLuint attribute, GLuint divisor) = 0;
+        virtual void DrawArraysInstanced(GLint first, GLsizei count, GLsizei instances) = 0;
+};
+
+// Straight through to OpenGL. The instancing entry points are looked up
+// through SDL the first time SupportsInstancing is asked, so it needs a
+// current context by then.
+class GLRenderDevice : public RenderDevice {
+    public:
+
+        GLRenderDevice();
+
+        void Clear();
+        void UseProgram(GLuint program);
+        void BindTexture(GLuint texture);
+        void BindArrayBuffer(GLuint buffer);
+        void SetAttributeEnabled(GLuint attribute, bool enabled);
+        void AttributePointer(GLuint attribute, GLsizei stride, const void *pointer, GLint size);
+        void UniformMatrix(GLint uniform, const float *matrix);
+        void UniformColor(GLint uniform, float r, float g, float b, float a);
+        GLuint CreateBuffer();
+        void DeleteBuffers(GLsizei count, const GLuint *buffers);
+        void BufferData(size_t bytes, const void *data);
+        void StreamBufferData(size_t bytes, const void *data);
+        void DrawArrays(GLint first, GLsizei count);
+        bool SupportsInstancing();
+        void AttributeDivisor(GLuint attribute, GLuint divisor);
+        void DrawArraysInstanced(GLint first, GLsizei count, GLsizei instances);
+
+        // set before the first frame to force the non-instanced paths
+        bool allowInstancing;
+
+    private:
+
+        bool instancingChecked;
+        bool instancing;
+};
+
+extern GLRenderDevice glRenderDevice;
+
+enum RenderCommandType {
+    RENDER_CLEAR, RENDER_USE_PROGRAM, RENDER_BIND_TEXTURE, RENDER_BIND_BUFFER,
+    RENDER_ENABLE_ATTRIBUTE, RENDER_DISABLE_ATTRIBUTE, RENDER_ATTRIBUTE_POINTER,
+    RENDER_ATTRIBUTE_DIVISOR, RENDER_UNIFORM, RENDER_CREATE_BUFFER, RENDER_DELETE_BUFFER,
+    RENDER_BUFFER_DATA, RENDER_DRAW, RENDER_DRAW_INSTANCED, RENDER_COMMAND_COUNT
+};
+
+extern const char *renderCommandNames[RENDER_COMMAND_COUNT];
+
+// target is the program, texture, buffer, attribute or uniform the command
+// is about; count is vertices for draws and bytes for buffer data, instances
+// is only set for instanced draws
+struct RenderCommand {
+    RenderCommandType type;
+    GLuint target;
+    GLint first;
+    GLsizei count;
+    GLsizei instances;
+};
+
+// Touches no GL at all: every command is kept in memory with running totals,
+// so draw calls, vertex counts and state changes can be checked on a machine
+// without a GPU. Buffers get made-up names counting up from 1. Whether it
+// claims to support instancing is up to the caller, so both paths can be
+// checked.
+class RecordingRenderDevice : public RenderDevice {
+    public:
+
+        RecordingRenderDevice(bool instancing = true);
+
+        void Clear();
+        void UseProgram(GLuint program);
+        void BindTexture(GLuint texture);
+        void BindArrayBuffer(GLuint buffer);
+        void SetAttributeEnabled(GLuint attribute, bool enabled);
+        void AttributePointer(GLuint attribute, GLsizei stride, const void *pointer, GLint size);
+        void UniformMatrix(GLint uniform, const float *matrix);
+        void UniformColor(GLint uniform, float r, float g, float b, float a);
+        GLuint CreateBuffer();
+        void DeleteBuffers(GLsizei count, const GLuint *buffers);
+        void BufferData(size_t bytes, const void *data);
+        void StreamBufferData(size_t bytes, const void *data);
+        void DrawArrays(GLint first, GLsizei count);
+        bool SupportsInstancing() { return instancing; }
+        void AttributeDivisor(GLuint attribute, GLuint divisor);
+        void DrawArraysInstanced(GLint first, GLsizei count, GLsizei instances);
+
+        // forgets the commands and totals, e.g. at the start of each frame
+        void Reset();
+        int Count(RenderCommandType type) const { return counts[type]; }
+        // one command per line
+        void Write(FILE *file) const;
+
+        std::vector<RenderCommand> commands;
+        int drawCalls;
+        int vertices;
+        // sprites (or whatever else) drawn by instanced draws
+        int instances;
+        // program, texture, buffer, attribute and uniform changes
+        int stateChanges;
+        size_t bufferBytes;
+
+    private:
+
+        void Add(RenderCommandType type, GLuint target, GLint first = 0, GLsizei count = 0, GLsizei instances = 0);
+
+        int counts[RENDER_COMMAND_COUNT];
+        GLuint nextBuffer;
+        bool instancing;
+};
@@ -0,0 +1,211 @@
+#include "RenderState.h"
+#include <cstring>
+
+RenderState renderState;
+
+RenderState::RenderState() : issuedCalls(0), skippedCalls(0), device(NULL), instancedAttributes(0) {
+    Invalidate();
+}
+
+void RenderState::SetDevice(RenderDevice *newDevice) {
+    device = newDevice;
+    Invalidate();
+    //a fresh device has every attribute advancing per vertex
+    instancedAttributes = 0;
+}
+
+void RenderState::Invalidate() {
+    //nothing is known until it has been set once through here
+    hasProgram = false;
+    hasTexture = false;
+    hasArrayBuffer = false;
+    attributesKnown = false;
+    enabledAttributes = 0;
+    programCount = 0;
+}
+
+void RenderState::UseProgram(const ShaderProgram &program) {
+    if(hasProgram && currentProgram == program.programID) {
+        skippedCalls++;
+        return;
+    }
+    device->UseProgram(program.programID);
+    hasProgram = true;
+    currentProgram = program.programID;
+    issuedCalls++;
+}
+
+void RenderState::BindTexture(GLuint texture) {
+    if(hasTexture && currentTexture == texture) {
+        skippedCalls++;
+        return;
+    }
+    device->BindTexture(texture);
+    hasTexture = true;
+    currentTexture = texture;
+    issuedCalls++;
+}
+
+void RenderState::BindArrayBuffer(GLuint buffer) {
+    if(hasArrayBuffer && currentArrayBuffer == buffer) {
+        skippedCalls++;
+        return;
+    }
+    device->BindArrayBuffer(buffer);
+    hasArrayBuffer = true;
+    currentArrayBuffer = buffer;
+    issuedCalls++;
+}
+
+uint32_t RenderState::AttributeBit(GLint attribute) {
+    return (attribute >= 0 && attribute < RENDER_STATE_ATTRIBUTES) ? 1u << attribute : 0;
+}
+
+void RenderState::UseAttributes(GLint position, GLint texCoord) {
+    UseAttributeMask(AttributeBit(position) | AttributeBit(texCoord));
+}
+
+void RenderState::UseAttributeMask(uint32_t wanted, uint32_t instanced) {
+
+    //a disabled attribute's divisor does not matter, so only enabled ones are
+    //brought in line. Divisors are only ever changed here, so unlike the
+    //enables they stay known across Invalidate.
+    uint32_t changedDivisors = (instanced ^ instancedAttributes) & wanted;
+    for(int i = 0; changedDivisors; i++, changedDivisors >>= 1) {
+        if(changedDivisors & 1) {
+            device->AttributeDivisor(i, (instanced >> i) & 1);
+            issuedCalls++;
+        }
+    }
+    instancedAttributes = (instancedAttributes & ~wanted) | (instanced & wanted);
+
+    for(int i = 0; i < RENDER_STATE_ATTRIBUTES; i++) {
+        uint32_t bit = 1u << i;
+        bool enable = (wanted & bit) != 0;
+        //until the first call nothing is known, so every attribute is set once
+        if(attributesKnown && enable == ((enabledAttributes & bit) != 0)) {
+            if(enable) { skippedCalls++; }
+            continue;
+        }
+        device->SetAttributeEnabled(i, enable);
+        issuedCalls++;
+    }
+    enabledAttributes = wanted;
+    attributesKnown = true;
+}
+
+RenderState::ProgramUniforms *RenderState::Uniforms(const ShaderProgram &program) {
+    for(int i = 0; i < programCount; i++) {
+        if(programs[i].programID == program.programID) { return &programs[i]; }
+    }
+    if(programCount == RENDER_STATE_MAX_PROGRAMS) {
+        return NULL;
+    }
+    ProgramUniforms &uniforms = programs[programCount++];
+    uniforms.programID = program.programID;
+    uniforms.hasModel = uniforms.hasView = uniforms.hasProjection = uniforms.hasColor = false;
+    return &uniforms;
+}
+
+bool RenderState::SetMatrix(GLuint uniform, bool &has, glm::mat4 &cached, const glm::mat4 &matrix) {
+    if(has && memcmp(&cached[0][0], &matrix[0][0], sizeof(float) * 16) == 0) {
+        skippedCalls++;
+        return false;
+    }
+    device->UniformMatrix(uniform, &matrix[0][0]);
+    has = true;
+    cached = matrix;
+    issuedCalls++;
+    return true;
+}
+
+void RenderState::SetModelMatrix(const ShaderProgram &program, const glm::mat4 &matrix) {
+    UseProgram(program);
+    ProgramUniforms *uniforms = Uniforms(program);
+    if(!uniforms) {
+        device->UniformMatrix(program.modelMatrixUniform, &matrix[0][0]);
+        issuedCalls++;
+        return;
+    }
+    SetMatrix(program.modelMatrixUniform, uniforms->hasModel, uniforms->model, matrix);
+}
+
+void RenderState::SetViewMatrix(const ShaderProgram &program, const glm::mat4 &matrix) {
+    UseProgram(program);
+    ProgramUniforms *uniforms = Uniforms(program);
+    if(!uniforms) {
+        device->UniformMatrix(program.viewMatrixUniform, &matrix[0][0]);
+        issuedCalls++;
+        return;
+    }
+    SetMatrix(program.viewMatrixUniform, uniforms->hasView, uniforms->view, matrix);
+}
+
+void RenderState::SetProjectionMatrix(const ShaderProgram &program, const glm::mat4 &matrix) {
+    UseProgram(program);
+    ProgramUniforms *uniforms = Uniforms(program);
+    if(!uniforms) {
+        device->UniformMatrix(program.projectionMatrixUniform, &matrix[0][0]);
+        issuedCalls++;
+        return;
+    }
+    SetMatrix(program.projectionMatrixUniform, uniforms->hasProjection, uniforms->projection, matrix);
+}
+
+void RenderState::SetColor(const ShaderProgram &program, float r, float g, float b, float a) {
+    UseProgram(program);
+    ProgramUniforms *uniforms = Uniforms(program);
+    if(uniforms && uniforms->hasColor && uniforms->color[0] == r && uniforms->color[1] == g && uniforms->color[2] == b && uniforms->color[3] == a) {
+        skippedCalls++;
+        return;
+    }
+    device->UniformColor(program.colorUniform, r, g, b, a);
+    issuedCalls++;
+    if(uniforms) {
+        uniforms->hasColor = true;
+        uniforms->color[0] = r;
+        uniforms->color[1] = g;
+        uniforms->color[2] = b;
+        uniforms->color[3] = a;
+    }
+}
+
+void RenderState::Clear() {
+    device->Clear();
+}
+
+void RenderState::AttributePointer(GLuint attribute, GLsizei stride, const void *pointer, GLint size) {
+    device->AttributePointer(attribute, stride, pointer, size);
+}
+
+void RenderState::DrawArrays(GLint first, GLsizei count) {
+    device->DrawArrays(first, count);
+}
+
+bool RenderState::SupportsInstancing() {
+    return device->SupportsInstancing();
+}
+
+void RenderState::DrawArraysInstanced(GLint first, GLsizei count, GLsizei instances) {
+    device->DrawArraysInstanced(first, count, instances);
+}
+
+GLuint RenderState::CreateBuffer() {
+    return device->CreateBuffer();
+}
+
+void RenderState::DeleteBuffers(GLsizei count, const GLuint *buffers) {
+    device->DeleteBuffers(count, buffers);
+    //GL unbinds a deleted buffer, and the name can come back from CreateBuffer
+    for(int i = 0; i < count; i++) {
+        if(hasArrayBuffer && currentArrayBuffer == buffers[i]) { currentArrayBuffer = 0; }
+    }
+}
+
+void RenderState::BufferData(size_t bytes, const void *data) {
+    device->BufferData(bytes, data);
+}
+
+void RenderState::StreamBufferData(size_t bytes, const void *data) {
+    device->StreamBufferData(bytes, data);
+}
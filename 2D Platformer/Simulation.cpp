@@ -0,0 +1,39 @@
+#include "Simulation.h"
+#include "Profiler.h"
+
+Simulation::Simulation(GameState &gameState) : state(gameState) {
+
+}
+
+Simulation::~Simulation() {
+    Stop();
+}
+
+void Simulation::Begin(double stepSeconds, int maxSteps) {
+    //so the renderer has something to draw before the first step lands
+    RenderSnapshot &snapshot = snapshots.WriteSlot();
+    state.WriteSnapshot(snapshot);
+    snapshot.time = Now();
+    snapshots.Publish();
+    Start(stepSeconds, maxSteps);
+}
+
+void Simulation::Step(uint64_t time) {
+    //one jump per press, however many frames or steps it was held for
+    inputs.Advance(time);
+    PlayerInput input;
+    input.left = inputs.Down(ACTION_LEFT);
+    input.right = inputs.Down(ACTION_RIGHT);
+    input.jumpHeld = inputs.Down(ACTION_JUMP);
+    input.jumpPresses = inputs.Pressed(ACTION_JUMP);
+
+    {
+        PROFILE_ZONE("update");
+        state.Update(FIXED_TIMESTEP, input);
+    }
+
+    RenderSnapshot &snapshot = snapshots.WriteSlot();
+    state.WriteSnapshot(snapshot);
+    snapshot.time = time;
+    snapshots.Publish();
+}
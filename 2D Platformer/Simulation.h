@@ -0,0 +1,34 @@
+#pragma once
+
+#include "GameState.h"
+#include "InputBuffer.h"
+#include "SimulationThread.h"
+#include "SnapshotBuffer.h"
+
+// what the keys are bound to
+enum PlatformerAction { ACTION_LEFT, ACTION_RIGHT, ACTION_JUMP };
+
+// Runs the platformer's GameState on its own thread at FIXED_TIMESTEP. The
+// main thread passes key events to inputs and draws the newest snapshot;
+// the GameState itself belongs to the simulation thread until Stop returns.
+class Simulation : public SimulationThread {
+    public:
+
+        Simulation(GameState &gameState);
+        ~Simulation();
+
+        // publishes a snapshot of the current state, then starts stepping;
+        // stepSeconds 0 runs flat out (see SimulationThread::Start)
+        void Begin(double stepSeconds = FIXED_TIMESTEP, int maxSteps = 0);
+
+        InputBuffer inputs;
+        SnapshotBuffer<RenderSnapshot> snapshots;
+
+    protected:
+
+        void Step(uint64_t time);
+
+    private:
+
+        GameState &state;
+};
@@ -0,0 +1,54 @@
+#include "SimulationThread.h"
+#include <chrono>
+
+SimulationThread::SimulationThread() : running(false), stopRequested(false), steps(0), stepNanoseconds(0), maxSteps(0) {
+
+}
+
+SimulationThread::~SimulationThread() {
+    Stop();
+}
+
+uint64_t SimulationThread::Now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulationThread::Start(double stepSeconds, int newMaxSteps) {
+    Stop();
+    stepNanoseconds = (uint64_t)(stepSeconds * 1000000000.0);
+    maxSteps = newMaxSteps;
+    steps.store(0, std::memory_order_relaxed);
+    stopRequested.store(false, std::memory_order_relaxed);
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&SimulationThread::Run, this);
+}
+
+void SimulationThread::Stop() {
+    stopRequested.store(true, std::memory_order_release);
+    if(thread.joinable()) {
+        thread.join();
+    }
+}
+
+void SimulationThread::Run() {
+
+    uint64_t next = Now();
+    while(!stopRequested.load(std::memory_order_acquire)) {
+        Step(next);
+        int done = steps.fetch_add(1, std::memory_order_acq_rel) + 1;
+        if(maxSteps && done >= maxSteps) { break; }
+        if(stepNanoseconds == 0) {
+            next = Now();
+            continue;
+        }
+
+        next += stepNanoseconds;
+        uint64_t now = Now();
+        if(now > next + stepNanoseconds * SIMULATION_MAX_BACKLOG) {
+            next = now;
+        } else if(next > now) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(next - now));
+        }
+    }
+    running.store(false, std::memory_order_release);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+// steps a paced simulation may fall behind before the backlog is dropped
+// (after a hitch, rather than spiralling trying to catch up)
+#define SIMULATION_MAX_BACKLOG 6
+
+// Calls Step on a thread of its own, once every stepSeconds of wall time, so
+// the simulation keeps its pace whatever the renderer and the buffer swap are
+// doing. The game's subclass takes input from the main thread and hands
+// results back through a SnapshotBuffer. Call Stop before the subclass goes
+// away.
+class SimulationThread {
+    public:
+
+        SimulationThread();
+        virtual ~SimulationThread();
+
+        // stepSeconds 0 runs flat out, for benchmarks; with maxSteps the
+        // thread finishes on its own after that many steps
+        void Start(double stepSeconds, int maxSteps = 0);
+        void Stop();
+
+        bool Running() const { return running.load(std::memory_order_acquire); }
+        int StepCount() const { return steps.load(std::memory_order_acquire); }
+
+        // steady clock in nanoseconds, the time base Step is given
+        static uint64_t Now();
+
+    protected:
+
+        // time is when this step was due, not when it actually ran
+        virtual void Step(uint64_t time) = 0;
+
+    private:
+
+        void Run();
+
+        std::thread thread;
+        std::atomic<bool> running;
+        std::atomic<bool> stopRequested;
+        std::atomic<int> steps;
+        uint64_t stepNanoseconds;
+        int maxSteps;
+};
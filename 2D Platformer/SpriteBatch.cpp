@@ -0,0 +1,104 @@
+#include "SpriteBatch.h"
+#include "RenderState.h"
+#include "glm/vec4.hpp"
+#include <algorithm>
+
+// unit quad corners: bottom left, bottom right, top right, top left
+static const float cornerX[4] = { -0.5f, 0.5f, 0.5f, -0.5f };
+static const float cornerY[4] = { -0.5f, -0.5f, 0.5f, 0.5f };
+
+bool SpriteBatch::QuadOrder::operator()(int a, int b) const {
+    const Quad &first = (*quads)[a];
+    const Quad &second = (*quads)[b];
+    if(first.layer != second.layer) { return first.layer < second.layer; }
+    if(first.program != second.program) { return first.program->programID < second.program->programID; }
+    if(first.texture != second.texture) { return first.texture < second.texture; }
+    return first.order < second.order;
+}
+
+SpriteBatch::SpriteBatch() : drawCallsLastFlush(0), quadsLastFlush(0) {
+
+}
+
+void SpriteBatch::Draw(ShaderProgram &program, GLuint texture, const glm::mat4 &transform,
+                       float u, float v, float width, float height, int layer) {
+    Quad quad;
+    quad.program = &program;
+    quad.texture = texture;
+    quad.layer = layer;
+    quad.order = (int)quads.size();
+    for(int i = 0; i < 4; i++) {
+        glm::vec4 corner = transform * glm::vec4(cornerX[i], cornerY[i], 0.0f, 1.0f);
+        quad.x[i] = corner.x;
+        quad.y[i] = corner.y;
+    }
+    quad.u = u;
+    quad.v = v;
+    quad.width = width;
+    quad.height = height;
+    quads.push_back(quad);
+}
+
+void SpriteBatch::DrawSheetSprite(ShaderProgram &program, GLuint texture, const glm::mat4 &transform,
+                                  int index, int spriteCountX, int spriteCountY, int layer) {
+    float u = (float)(index % spriteCountX) / (float) spriteCountX;
+    float v = (float)(index / spriteCountX) / (float) spriteCountY;
+    Draw(program, texture, transform, u, v, 1.0f/(float)spriteCountX, 1.0f/(float)spriteCountY, layer);
+}
+
+void SpriteBatch::Flush() {
+
+    drawCallsLastFlush = 0;
+    quadsLastFlush = (int)quads.size();
+    if(quads.empty()) { return; }
+
+    sorted.resize(quads.size());
+    for(int i = 0; i < (int)sorted.size(); i++) { sorted[i] = i; }
+    QuadOrder order = { &quads };
+    std::sort(sorted.begin(), sorted.end(), order);
+
+    //two triangles per quad, x y u v interleaved; texture v runs down the sheet
+    vertices.resize(quads.size() * 6 * 4);
+    float *out = &vertices[0];
+    static const int triangleCorners[6] = { 0, 1, 2, 0, 2, 3 };
+    for(int i = 0; i < (int)sorted.size(); i++) {
+        const Quad &quad = quads[sorted[i]];
+        for(int j = 0; j < 6; j++) {
+            int corner = triangleCorners[j];
+            *out++ = quad.x[corner];
+            *out++ = quad.y[corner];
+            *out++ = (corner == 0 || corner == 3) ? quad.u : quad.u + quad.width;
+            *out++ = (corner >= 2) ? quad.v : quad.v + quad.height;
+        }
+    }
+
+    glm::mat4 identity = glm::mat4(1.0f);
+    ShaderProgram *currentProgram = NULL;
+    int runStart = 0;
+    for(int i = 1; i <= (int)sorted.size(); i++) {
+        const Quad &first = quads[sorted[runStart]];
+        if(i < (int)sorted.size()) {
+            const Quad &next = quads[sorted[i]];
+            if(next.program == first.program && next.texture == first.texture) { continue; }
+        }
+
+        if(first.program != currentProgram) {
+            currentProgram = first.program;
+            renderState.SetModelMatrix(*currentProgram, identity);
+            renderState.BindArrayBuffer(0);
+            renderState.AttributePointer(currentProgram->positionAttribute, 4 * sizeof(float), &vertices[0]);
+            //untextured programs have no texCoord attribute
+            if((GLint)currentProgram->texCoordAttribute >= 0) {
+                renderState.AttributePointer(currentProgram->texCoordAttribute, 4 * sizeof(float), &vertices[2]);
+            }
+            renderState.UseAttributes(currentProgram->positionAttribute, currentProgram->texCoordAttribute);
+        }
+        renderState.BindTexture(first.texture);
+        renderState.DrawArrays(runStart * 6, (i - runStart) * 6);
+        drawCallsLastFlush++;
+
+        runStart = i;
+    }
+
+    quads.clear();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+#include <vector>
+
+#include "ShaderProgram.h"
+#include "glm/mat4x4.hpp"
+
+// Collects textured quads for a frame and draws them with as few draw calls
+// as possible. Each quad is a unit square (-0.5..0.5) pushed through its own
+// transform on the CPU, so sprites that share a program and texture go out in
+// one glDrawArrays no matter how many model matrices they had.
+//
+// Flush sorts by layer, then program, then texture; quads with the same key
+// keep their submission order. Use layers when blending order matters across
+// textures (e.g. text over sprites).
+class SpriteBatch {
+    public:
+
+        SpriteBatch();
+
+        // uv rect is the top left corner of the region and its size in texture space
+        void Draw(ShaderProgram &program, GLuint texture, const glm::mat4 &transform,
+                  float u, float v, float width, float height, int layer = 0);
+
+        // one cell of a uniform sprite sheet, counted left to right, top to bottom
+        void DrawSheetSprite(ShaderProgram &program, GLuint texture, const glm::mat4 &transform,
+                             int index, int spriteCountX, int spriteCountY, int layer = 0);
+
+        // draws everything collected so far and leaves the batch empty; the
+        // programs' model matrices are reset to identity, view and projection
+        // are whatever the caller set
+        void Flush();
+
+        int QuadCount() const { return (int)quads.size(); }
+
+        int drawCallsLastFlush;
+        int quadsLastFlush;
+
+    private:
+
+        struct Quad {
+            ShaderProgram *program;
+            GLuint texture;
+            int layer;
+            int order;
+            float x[4];
+            float y[4];
+            float u;
+            float v;
+            float width;
+            float height;
+        };
+
+        struct QuadOrder {
+            const std::vector<Quad> *quads;
+            bool operator()(int a, int b) const;
+        };
+
+        std::vector<Quad> quads;
+        std::vector<int> sorted;
+        std::vector<float> vertices;
+};
@@ -0,0 +1,184 @@
+#include "SpriteInstancer.h"
+#include "RenderState.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+
+// unit quad as two triangles, x y u v; v runs down the sheet like SpriteBatch
+static const float unitQuad[6 * 4] = {
+    -0.5f, -0.5f, 0.0f, 1.0f,
+     0.5f, -0.5f, 1.0f, 1.0f,
+     0.5f,  0.5f, 1.0f, 0.0f,
+    -0.5f, -0.5f, 0.0f, 1.0f,
+     0.5f,  0.5f, 1.0f, 0.0f,
+    -0.5f,  0.5f, 0.0f, 0.0f
+};
+
+static bool keyBefore(int layerA, GLuint textureA, int layerB, GLuint textureB) {
+    if(layerA != layerB) { return layerA < layerB; }
+    return textureA < textureB;
+}
+
+bool SpriteInstancer::KeyOrder::operator()(int a, int b) const {
+    const InstanceKey &first = (*keys)[a];
+    const InstanceKey &second = (*keys)[b];
+    if(keyBefore(first.layer, first.texture, second.layer, second.texture)) { return true; }
+    if(keyBefore(second.layer, second.texture, first.layer, first.texture)) { return false; }
+    return a < b;
+}
+
+SpriteInstancer::SpriteInstancer() : drawCallsLastFlush(0), spritesLastFlush(0), instancing(false), program(NULL),
+    fallbackProgram(NULL), inOrder(true), quadBuffer(0), instanceBuffer(0) {
+    InstanceAttributes none = { -1, -1, -1 };
+    attributes = none;
+    SetTint(1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+void SpriteInstancer::Setup(ShaderProgram *instancedProgram, const InstanceAttributes &instanceAttributes, ShaderProgram *batchProgram) {
+    program = instancedProgram;
+    attributes = instanceAttributes;
+    fallbackProgram = batchProgram;
+    //a failed shader load leaves every location at -1
+    instancing = program && renderState.SupportsInstancing() &&
+        (GLint)program->positionAttribute >= 0 && (GLint)program->texCoordAttribute >= 0 &&
+        attributes.placement >= 0 && attributes.uvRect >= 0 && attributes.tint >= 0;
+}
+
+void SpriteInstancer::SetMatrices(const glm::mat4 &projectionMatrix, const glm::mat4 &viewMatrix) {
+    ShaderProgram *drawing = instancing ? program : fallbackProgram;
+    renderState.SetProjectionMatrix(*drawing, projectionMatrix);
+    renderState.SetViewMatrix(*drawing, viewMatrix);
+}
+
+void SpriteInstancer::SetTint(float r, float g, float b, float a) {
+    tint[0] = r;
+    tint[1] = g;
+    tint[2] = b;
+    tint[3] = a;
+}
+
+void SpriteInstancer::Draw(GLuint texture, float x, float y, float width, float height,
+                           float u, float v, float uvWidth, float uvHeight, int layer) {
+    if(!instancing) {
+        glm::mat4 transform = glm::mat4(1.0f);
+        transform = glm::translate(transform, glm::vec3(x, y, 0.0f));
+        transform = glm::scale(transform, glm::vec3(width, height, 1.0f));
+        fallback.Draw(*fallbackProgram, texture, transform, u, v, uvWidth, uvHeight, layer);
+        return;
+    }
+
+    if(!keys.empty() && keyBefore(layer, texture, keys.back().layer, keys.back().texture)) {
+        inOrder = false;
+    }
+    InstanceKey key = { layer, texture };
+    keys.push_back(key);
+
+    size_t start = instances.size();
+    instances.resize(start + SPRITE_INSTANCE_FLOATS);
+    float *out = &instances[start];
+    out[0] = x;
+    out[1] = y;
+    out[2] = width;
+    out[3] = height;
+    out[4] = u;
+    out[5] = v;
+    out[6] = uvWidth;
+    out[7] = uvHeight;
+    out[8] = tint[0];
+    out[9] = tint[1];
+    out[10] = tint[2];
+    out[11] = tint[3];
+}
+
+void SpriteInstancer::DrawSheetSprite(GLuint texture, float x, float y, float width, float height,
+                                      int index, int spriteCountX, int spriteCountY, int layer) {
+    float u = (float)(index % spriteCountX) / (float) spriteCountX;
+    float v = (float)(index / spriteCountX) / (float) spriteCountY;
+    Draw(texture, x, y, width, height, u, v, 1.0f/(float)spriteCountX, 1.0f/(float)spriteCountY, layer);
+}
+
+void SpriteInstancer::Flush() {
+
+    if(!instancing) {
+        fallback.Flush();
+        drawCallsLastFlush = fallback.drawCallsLastFlush;
+        spritesLastFlush = fallback.quadsLastFlush;
+        return;
+    }
+
+    drawCallsLastFlush = 0;
+    spritesLastFlush = (int)keys.size();
+    if(keys.empty()) { return; }
+
+    //callers mostly draw one kind of sprite at a time, so this is usually skipped
+    const float *data = &instances[0];
+    if(!inOrder) {
+        sorted.resize(keys.size());
+        for(int i = 0; i < (int)sorted.size(); i++) { sorted[i] = i; }
+        KeyOrder order = { &keys };
+        std::sort(sorted.begin(), sorted.end(), order);
+
+        sortedInstances.resize(instances.size());
+        sortedKeys.resize(keys.size());
+        for(int i = 0; i < (int)sorted.size(); i++) {
+            std::copy(&instances[sorted[i] * SPRITE_INSTANCE_FLOATS], &instances[sorted[i] * SPRITE_INSTANCE_FLOATS] + SPRITE_INSTANCE_FLOATS,
+                      &sortedInstances[i * SPRITE_INSTANCE_FLOATS]);
+            sortedKeys[i] = keys[sorted[i]];
+        }
+        keys.swap(sortedKeys);
+        data = &sortedInstances[0];
+    }
+
+    if(quadBuffer == 0) {
+        quadBuffer = renderState.CreateBuffer();
+        renderState.BindArrayBuffer(quadBuffer);
+        renderState.BufferData(sizeof(unitQuad), unitQuad);
+    }
+    if(instanceBuffer == 0) {
+        instanceBuffer = renderState.CreateBuffer();
+    }
+
+    renderState.SetModelMatrix(*program, glm::mat4(1.0f));
+
+    renderState.BindArrayBuffer(quadBuffer);
+    renderState.AttributePointer(program->positionAttribute, 4 * sizeof(float), (void*)0);
+    renderState.AttributePointer(program->texCoordAttribute, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    uint32_t perInstance = RenderState::AttributeBit(attributes.placement) | RenderState::AttributeBit(attributes.uvRect) |
+        RenderState::AttributeBit(attributes.tint);
+    renderState.UseAttributeMask(RenderState::AttributeBit(program->positionAttribute) | RenderState::AttributeBit(program->texCoordAttribute) |
+        perInstance, perInstance);
+
+    renderState.BindArrayBuffer(instanceBuffer);
+    renderState.StreamBufferData(keys.size() * SPRITE_INSTANCE_FLOATS * sizeof(float), data);
+
+    //no base instance before GL 4.2, so each run points the instance attributes at its own slice
+    GLsizei stride = SPRITE_INSTANCE_FLOATS * sizeof(float);
+    int runStart = 0;
+    for(int i = 1; i <= (int)keys.size(); i++) {
+        const InstanceKey &first = keys[runStart];
+        if(i < (int)keys.size() && keys[i].layer == first.layer && keys[i].texture == first.texture) { continue; }
+
+        size_t slice = (size_t)runStart * stride;
+        renderState.AttributePointer(attributes.placement, stride, (void*)slice, 4);
+        renderState.AttributePointer(attributes.uvRect, stride, (void*)(slice + 4 * sizeof(float)), 4);
+        renderState.AttributePointer(attributes.tint, stride, (void*)(slice + 8 * sizeof(float)), 4);
+        renderState.BindTexture(first.texture);
+        renderState.DrawArraysInstanced(0, 6, i - runStart);
+        drawCallsLastFlush++;
+
+        runStart = i;
+    }
+
+    keys.clear();
+    instances.clear();
+    inOrder = true;
+}
+
+void SpriteInstancer::Cleanup() {
+    GLuint buffers[2] = { quadBuffer, instanceBuffer };
+    if(quadBuffer || instanceBuffer) {
+        renderState.DeleteBuffers(2, buffers);
+    }
+    quadBuffer = 0;
+    instanceBuffer = 0;
+}
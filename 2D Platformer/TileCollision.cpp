@@ -0,0 +1,193 @@
+#include "TileCollision.h"
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+// keeps a box that is resting exactly on a tile edge from counting as inside it
+#define TILE_EPSILON 0.0001f
+// pushes PushOut tries before giving up on a box buried deep in tiles
+#define TILE_PUSH_PASSES 4
+
+void worldToTileCoordinates(float worldX, float worldY, int *gridX, int *gridY, float TILE_SIZE) {
+    // floor rather than truncate so positions left of or above the map stay outside it
+    *gridX = (int)floorf(worldX / TILE_SIZE);
+    *gridY = (int)floorf(worldY / -TILE_SIZE);
+}
+
+TileCollision::TileCollision() : map(NULL), tileSize(1.0f) {
+
+}
+
+void TileCollision::SetMap(const LevelMap *newMap, float newTileSize) {
+    map = newMap;
+    tileSize = newTileSize;
+}
+
+bool TileCollision::IsSolid(int gridX, int gridY) const {
+    if(map == NULL || gridX < 0 || gridY < 0 || gridX >= map->mapWidth || gridY >= map->mapHeight) {
+        return false;
+    }
+    return map->TileAt(gridX, gridY) != 0;
+}
+
+TileContacts TileCollision::Move(float &x, float &y, float width, float height, float deltaX, float deltaY) const {
+
+    TileContacts contacts = { false, false, false, false };
+
+    PushOut(x, y, width, height, contacts);
+    x = SweepX(x, y, width, height, deltaX, contacts);
+    y = SweepY(x, y, width, height, deltaY, contacts);
+
+    return contacts;
+}
+
+void TileCollision::PushOut(float &x, float &y, float width, float height, TileContacts &contacts) const {
+
+    if(map == NULL) { return; }
+
+    //one push per pass, the shortest first, so a box wedged between tiles
+    //leaves by the open side; each pass looks again at the cells it covers
+    for(int pass = 0; pass < TILE_PUSH_PASSES; pass++) {
+        int leftColumn, rightColumn, topRow, bottomRow;
+        worldToTileCoordinates(x - width/2 + TILE_EPSILON, y + height/2 - TILE_EPSILON, &leftColumn, &topRow, tileSize);
+        worldToTileCoordinates(x + width/2 - TILE_EPSILON, y - height/2 + TILE_EPSILON, &rightColumn, &bottomRow, tileSize);
+        leftColumn = std::max(leftColumn, 0);
+        rightColumn = std::min(rightColumn, map->mapWidth - 1);
+        topRow = std::max(topRow, 0);
+        bottomRow = std::min(bottomRow, map->mapHeight - 1);
+
+        float shortest = FLT_MAX;
+        float pushX = 0.0f;
+        float pushY = 0.0f;
+        for(int row = topRow; row <= bottomRow; row++) {
+            for(int column = leftColumn; column <= rightColumn; column++) {
+                if(!IsSolid(column, row)) { continue; }
+
+                //up onto the tile, as landing on it would
+                float up = (-tileSize * row) - (y - height/2);
+                if(up < shortest) {
+                    shortest = up;
+                    pushX = 0.0f;
+                    pushY = up;
+                }
+                //sideways only towards an open neighbour
+                float left = (x + width/2) - (tileSize * column);
+                if(left < shortest && !IsSolid(column - 1, row)) {
+                    shortest = left;
+                    pushX = -left;
+                    pushY = 0.0f;
+                }
+                float right = (tileSize * column + tileSize) - (x - width/2);
+                if(right < shortest && !IsSolid(column + 1, row)) {
+                    shortest = right;
+                    pushX = right;
+                    pushY = 0.0f;
+                }
+            }
+        }
+        if(shortest == FLT_MAX) { return; }
+
+        x += pushX;
+        y += pushY;
+        if(pushY > 0.0f) { contacts.bottom = true; }
+        if(pushX < 0.0f) { contacts.right = true; }
+        if(pushX > 0.0f) { contacts.left = true; }
+    }
+}
+
+float TileCollision::SweepX(float x, float y, float width, float height, float deltaX, TileContacts &contacts) const {
+
+    if(deltaX == 0.0f || map == NULL) { return x + deltaX; }
+
+    // rows covered by the box
+    int unused, topRow, bottomRow;
+    worldToTileCoordinates(x, y + height/2 - TILE_EPSILON, &unused, &topRow, tileSize);
+    worldToTileCoordinates(x, y - height/2 + TILE_EPSILON, &unused, &bottomRow, tileSize);
+    topRow = std::max(topRow, 0);
+    bottomRow = std::min(bottomRow, map->mapHeight - 1);
+
+    if(deltaX > 0.0f) {
+        float right = x + width/2;
+        int startColumn, endColumn, row;
+        worldToTileCoordinates(right - TILE_EPSILON, y, &startColumn, &row, tileSize);
+        worldToTileCoordinates(right + deltaX - TILE_EPSILON, y, &endColumn, &row, tileSize);
+        startColumn = std::max(startColumn, 0);
+        endColumn = std::min(endColumn, map->mapWidth - 1);
+
+        for(int column = startColumn; column <= endColumn; column++) {
+            for(int r = topRow; r <= bottomRow; r++) {
+                if(IsSolid(column, r)) {
+                    contacts.right = true;
+                    return (tileSize * column) - width/2;
+                }
+            }
+        }
+    } else {
+        float left = x - width/2;
+        int startColumn, endColumn, row;
+        worldToTileCoordinates(left + TILE_EPSILON, y, &startColumn, &row, tileSize);
+        worldToTileCoordinates(left + deltaX + TILE_EPSILON, y, &endColumn, &row, tileSize);
+        startColumn = std::min(startColumn, map->mapWidth - 1);
+        endColumn = std::max(endColumn, 0);
+
+        for(int column = startColumn; column >= endColumn; column--) {
+            for(int r = topRow; r <= bottomRow; r++) {
+                if(IsSolid(column, r)) {
+                    contacts.left = true;
+                    return (tileSize * column) + tileSize + width/2;
+                }
+            }
+        }
+    }
+
+    return x + deltaX;
+}
+
+float TileCollision::SweepY(float x, float y, float width, float height, float deltaY, TileContacts &contacts) const {
+
+    if(deltaY == 0.0f || map == NULL) { return y + deltaY; }
+
+    // columns covered by the box, after the horizontal move
+    int leftColumn, rightColumn, unused;
+    worldToTileCoordinates(x - width/2 + TILE_EPSILON, y, &leftColumn, &unused, tileSize);
+    worldToTileCoordinates(x + width/2 - TILE_EPSILON, y, &rightColumn, &unused, tileSize);
+    leftColumn = std::max(leftColumn, 0);
+    rightColumn = std::min(rightColumn, map->mapWidth - 1);
+
+    if(deltaY < 0.0f) {
+        // falling: rows grow downwards
+        float bottom = y - height/2;
+        int startRow, endRow, column;
+        worldToTileCoordinates(x, bottom + TILE_EPSILON, &column, &startRow, tileSize);
+        worldToTileCoordinates(x, bottom + deltaY + TILE_EPSILON, &column, &endRow, tileSize);
+        startRow = std::max(startRow, 0);
+        endRow = std::min(endRow, map->mapHeight - 1);
+
+        for(int row = startRow; row <= endRow; row++) {
+            for(int c = leftColumn; c <= rightColumn; c++) {
+                if(IsSolid(c, row)) {
+                    contacts.bottom = true;
+                    return (-tileSize * row) + height/2;
+                }
+            }
+        }
+    } else {
+        float top = y + height/2;
+        int startRow, endRow, column;
+        worldToTileCoordinates(x, top - TILE_EPSILON, &column, &startRow, tileSize);
+        worldToTileCoordinates(x, top + deltaY - TILE_EPSILON, &column, &endRow, tileSize);
+        startRow = std::min(startRow, map->mapHeight - 1);
+        endRow = std::max(endRow, 0);
+
+        for(int row = startRow; row >= endRow; row--) {
+            for(int c = leftColumn; c <= rightColumn; c++) {
+                if(IsSolid(c, row)) {
+                    contacts.top = true;
+                    return (-tileSize * row) - tileSize - height/2;
+                }
+            }
+        }
+    }
+
+    return y + deltaY;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "LevelMap.h"
+
+void worldToTileCoordinates(float worldX, float worldY, int *gridX, int *gridY, float TILE_SIZE);
+
+// which sides of a body touched a solid tile during the last move
+struct TileContacts {
+    bool top;
+    bool bottom;
+    bool left;
+    bool right;
+};
+
+// Grid indexed collision against the solid (non-zero) tiles of a LevelMap.
+// A move only looks at the cells covered by the body's swept box, resolving
+// X first and then Y, so the cost per body does not depend on the map size
+// and fast bodies cannot skip over thin platforms. A body that already
+// overlaps a tile, such as one spawned inside the floor, is pushed out first.
+class TileCollision {
+    public:
+
+        TileCollision();
+
+        void SetMap(const LevelMap *map, float tileSize);
+        bool IsSolid(int gridX, int gridY) const;
+
+        // x/y is the center of a width by height box; moves it by deltaX/deltaY
+        // and stops it flush against the first solid tile in the way. A box that
+        // starts inside tiles is first pushed out the shortest way: up onto the
+        // tile, or sideways into an open cell
+        TileContacts Move(float &x, float &y, float width, float height, float deltaX, float deltaY) const;
+
+    private:
+
+        void PushOut(float &x, float &y, float width, float height, TileContacts &contacts) const;
+        float SweepX(float x, float y, float width, float height, float deltaX, TileContacts &contacts) const;
+        float SweepY(float x, float y, float width, float height, float deltaY, TileContacts &contacts) const;
+
+        const LevelMap *map;
+        float tileSize;
+};
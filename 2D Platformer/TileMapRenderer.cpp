@@ -0,0 +1,198 @@
+#include "TileMapRenderer.h"
+#include "RenderState.h"
+#include "glm/matrix.hpp"
+#include <cmath>
+#include <algorithm>
+
+// interleaved x, y, u, v
+#define FLOATS_PER_VERTEX 4
+
+static int FloorDiv(int value, int divisor) {
+    return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+TileMapRenderer::TileMapRenderer() : chunksBuiltLastUpdate(0), chunksDrawnLastDraw(0), map(NULL), tileSize(1.0f), spriteCountX(1), spriteCountY(1),
+    chunkCountX(0), chunkCountY(0), visibleMinX(0), visibleMaxX(-1), visibleMinY(0), visibleMaxY(-1) {
+
+}
+
+void TileMapRenderer::SetMap(const LevelMap *newMap, float newTileSize, int newSpriteCountX, int newSpriteCountY) {
+
+    // drop every resident chunk but keep the buffers for reuse
+    while(!chunks.empty()) {
+        EvictChunk((int)chunks.size() - 1);
+    }
+
+    map = newMap;
+    tileSize = newTileSize;
+    spriteCountX = newSpriteCountX;
+    spriteCountY = newSpriteCountY;
+
+    chunkCountX = map ? (map->mapWidth + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE : 0;
+    chunkCountY = map ? (map->mapHeight + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE : 0;
+
+    visibleMinX = visibleMinY = 0;
+    visibleMaxX = visibleMaxY = -1;
+
+    scratch.reserve(TILE_CHUNK_SIZE * TILE_CHUNK_SIZE * 6 * FLOATS_PER_VERTEX);
+}
+
+void TileMapRenderer::Update(const glm::mat4 &projectionMatrix, const glm::mat4 &viewMatrix) {
+
+    chunksBuiltLastUpdate = 0;
+    if(map == NULL || chunkCountX == 0 || chunkCountY == 0) { return; }
+
+    // world space rectangle covered by the screen
+    glm::mat4 screenToWorld = glm::inverse(projectionMatrix * viewMatrix);
+    glm::vec4 cornerA = screenToWorld * glm::vec4(-1.0f, -1.0f, 0.0f, 1.0f);
+    glm::vec4 cornerB = screenToWorld * glm::vec4(1.0f, 1.0f, 0.0f, 1.0f);
+
+    float minWorldX = fminf(cornerA.x, cornerB.x);
+    float maxWorldX = fmaxf(cornerA.x, cornerB.x);
+    float minWorldY = fminf(cornerA.y, cornerB.y);
+    float maxWorldY = fmaxf(cornerA.y, cornerB.y);
+
+    // rows grow downwards, so the top of the screen is the smallest row
+    int minTileX = (int)floorf(minWorldX / tileSize);
+    int maxTileX = (int)floorf(maxWorldX / tileSize);
+    int minTileY = (int)floorf(maxWorldY / -tileSize);
+    int maxTileY = (int)floorf(minWorldY / -tileSize);
+
+    visibleMinX = std::max(FloorDiv(minTileX, TILE_CHUNK_SIZE), 0);
+    visibleMaxX = std::min(FloorDiv(maxTileX, TILE_CHUNK_SIZE), chunkCountX - 1);
+    visibleMinY = std::max(FloorDiv(minTileY, TILE_CHUNK_SIZE), 0);
+    visibleMaxY = std::min(FloorDiv(maxTileY, TILE_CHUNK_SIZE), chunkCountY - 1);
+
+    // evict chunks that scrolled well out of range; the extra chunk of slack
+    // keeps a player standing on a chunk border from rebuilding every frame
+    for(int i = (int)chunks.size() - 1; i >= 0; i--) {
+        const TileChunk &chunk = chunks[i];
+        if(chunk.chunkX < visibleMinX - TILE_CHUNK_MARGIN - 1 || chunk.chunkX > visibleMaxX + TILE_CHUNK_MARGIN + 1 ||
+           chunk.chunkY < visibleMinY - TILE_CHUNK_MARGIN - 1 || chunk.chunkY > visibleMaxY + TILE_CHUNK_MARGIN + 1) {
+            EvictChunk(i);
+        }
+    }
+
+    int prefetchBudget = TILE_CHUNK_BUILDS_PER_FRAME;
+    for(int cy = visibleMinY - TILE_CHUNK_MARGIN; cy <= visibleMaxY + TILE_CHUNK_MARGIN; cy++) {
+        for(int cx = visibleMinX - TILE_CHUNK_MARGIN; cx <= visibleMaxX + TILE_CHUNK_MARGIN; cx++) {
+
+            if(cx < 0 || cy < 0 || cx >= chunkCountX || cy >= chunkCountY) { continue; }
+            if(FindChunk(cx, cy) != -1) { continue; }
+
+            // visible chunks are always built, the margin ring only within budget
+            bool visible = cx >= visibleMinX && cx <= visibleMaxX && cy >= visibleMinY && cy <= visibleMaxY;
+            if(!visible) {
+                if(prefetchBudget == 0) { continue; }
+                prefetchBudget--;
+            }
+
+            TileChunk chunk;
+            chunk.chunkX = cx;
+            chunk.chunkY = cy;
+            chunk.vertexCount = 0;
+            if(!freeBuffers.empty()) {
+                chunk.vertexBuffer = freeBuffers.back();
+                freeBuffers.pop_back();
+            } else {
+                chunk.vertexBuffer = renderState.CreateBuffer();
+            }
+            BuildChunk(chunk);
+            chunks.push_back(chunk);
+            chunksBuiltLastUpdate++;
+        }
+    }
+}
+
+void TileMapRenderer::BuildChunk(TileChunk &chunk) {
+
+    float spriteWidth = 1.0f/(float)spriteCountX;
+    float spriteHeight = 1.0f/(float)spriteCountY;
+
+    int startX = chunk.chunkX * TILE_CHUNK_SIZE;
+    int startY = chunk.chunkY * TILE_CHUNK_SIZE;
+    int endX = std::min(startX + TILE_CHUNK_SIZE, map->mapWidth);
+    int endY = std::min(startY + TILE_CHUNK_SIZE, map->mapHeight);
+
+    scratch.clear();
+
+    for(int y=startY; y < endY; y++) {
+        for(int x=startX; x < endX; x++) {
+
+            int tile = (int)map->TileAt(x, y);
+            if(tile == 0) { continue; }
+
+            float u = (float)(tile % spriteCountX) / (float) spriteCountX;
+            float v = (float)(tile / spriteCountX) / (float) spriteCountY;
+
+            float left = tileSize * x;
+            float right = (tileSize * x) + tileSize;
+            float top = -tileSize * y;
+            float bottom = (-tileSize * y) - tileSize;
+
+            scratch.insert(scratch.end(), {
+                left, top, u, v,
+                left, bottom, u, v+spriteHeight,
+                right, bottom, u+spriteWidth, v+spriteHeight,
+                left, top, u, v,
+                right, bottom, u+spriteWidth, v+spriteHeight,
+                right, top, u+spriteWidth, v });
+        }
+    }
+
+    chunk.vertexCount = (int)(scratch.size() / FLOATS_PER_VERTEX);
+    if(chunk.vertexCount == 0) { return; }
+
+    renderState.BindArrayBuffer(chunk.vertexBuffer);
+    renderState.BufferData(scratch.size() * sizeof(float), scratch.data());
+    renderState.BindArrayBuffer(0);
+}
+
+void TileMapRenderer::EvictChunk(int index) {
+    freeBuffers.push_back(chunks[index].vertexBuffer);
+    chunks[index] = chunks.back();
+    chunks.pop_back();
+}
+
+int TileMapRenderer::FindChunk(int chunkX, int chunkY) const {
+    // only a handful of chunks are ever resident, a linear scan is plenty
+    for(int i = 0; i < (int)chunks.size(); i++) {
+        if(chunks[i].chunkX == chunkX && chunks[i].chunkY == chunkY) { return i; }
+    }
+    return -1;
+}
+
+void TileMapRenderer::Draw(ShaderProgram &program, GLuint texture) {
+
+    renderState.UseProgram(program);
+    renderState.BindTexture(texture);
+    renderState.UseAttributes(program.positionAttribute, program.texCoordAttribute);
+
+    chunksDrawnLastDraw = 0;
+    GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+    for(int i = 0; i < (int)chunks.size(); i++) {
+        const TileChunk &chunk = chunks[i];
+        if(chunk.vertexCount == 0) { continue; }
+        if(chunk.chunkX < visibleMinX || chunk.chunkX > visibleMaxX || chunk.chunkY < visibleMinY || chunk.chunkY > visibleMaxY) { continue; }
+
+        renderState.BindArrayBuffer(chunk.vertexBuffer);
+        renderState.AttributePointer(program.positionAttribute, stride, (void*)0);
+        renderState.AttributePointer(program.texCoordAttribute, stride, (void*)(2 * sizeof(float)));
+        renderState.DrawArrays(0, chunk.vertexCount);
+        chunksDrawnLastDraw++;
+    }
+
+    // the sprite code still draws from client-side arrays, so leave no buffer bound
+    renderState.BindArrayBuffer(0);
+}
+
+void TileMapRenderer::Cleanup() {
+    while(!chunks.empty()) {
+        EvictChunk((int)chunks.size() - 1);
+    }
+    if(!freeBuffers.empty()) {
+        renderState.DeleteBuffers((GLsizei)freeBuffers.size(), freeBuffers.data());
+        freeBuffers.clear();
+    }
+    map = NULL;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+#include <vector>
+
+#include "ShaderProgram.h"
+#include "LevelMap.h"
+#include "glm/mat4x4.hpp"
+
+// tiles per chunk side; a chunk is meshed into its own static vertex buffer
+#define TILE_CHUNK_SIZE 32
+
+// chunks kept around the visible area so scrolling never waits on a build
+#define TILE_CHUNK_MARGIN 1
+
+// prefetch builds allowed per frame outside the visible area
+#define TILE_CHUNK_BUILDS_PER_FRAME 1
+
+struct TileChunk {
+    int chunkX;
+    int chunkY;
+    GLuint vertexBuffer;
+    int vertexCount;
+};
+
+// Splits the tile layer of a LevelMap into TILE_CHUNK_SIZE square chunks and
+// keeps only the ones near the camera meshed and resident on the GPU. Chunks
+// stream in and out as the view scrolls, so the per frame cost and the number
+// of live buffers depend on the screen size rather than the level size.
+class TileMapRenderer {
+    public:
+
+        TileMapRenderer();
+
+        void SetMap(const LevelMap *map, float tileSize, int spriteCountX, int spriteCountY);
+        void Update(const glm::mat4 &projectionMatrix, const glm::mat4 &viewMatrix);
+        void Draw(ShaderProgram &program, GLuint texture);
+        void Cleanup();
+
+        // chunk stats, handy when tuning TILE_CHUNK_SIZE
+        int ResidentChunkCount() const { return (int)chunks.size(); }
+        int chunksBuiltLastUpdate;
+        // chunks with tiles in them that the last Draw issued
+        int chunksDrawnLastDraw;
+
+    private:
+
+        void BuildChunk(TileChunk &chunk);
+        void EvictChunk(int index);
+        int FindChunk(int chunkX, int chunkY) const;
+
+        const LevelMap *map;
+        float tileSize;
+        int spriteCountX;
+        int spriteCountY;
+
+        int chunkCountX;
+        int chunkCountY;
+
+        // visible chunk range from the last Update, inclusive
+        int visibleMinX, visibleMaxX;
+        int visibleMinY, visibleMaxY;
+
+        std::vector<TileChunk> chunks;
+        std::vector<GLuint> freeBuffers;
+        std::vector<float> scratch;
+};
@@ -0,0 +1,51 @@
+#include "WorldRenderer.h"
+#include "RenderState.h"
+#include "Profiler.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+void DrawWorld(const RenderSnapshot &snapshot, float alpha, ShaderProgram &program, ShaderProgram &texturedProgram, GLuint sheetTexture,
+               const glm::mat4 &projectionMatrix, TileMapRenderer &tileMapRenderer, SpriteInstancer &sprites) {
+
+    float cameraX = lerp(snapshot.previousCameraX, snapshot.cameraX, alpha);
+    float cameraY = lerp(snapshot.previousCameraY, snapshot.cameraY, alpha);
+
+    //scroll view w/ player
+    glm::mat4 viewMatrix = glm::mat4(1.0f);
+    viewMatrix = glm::translate(viewMatrix, glm::vec3(-1 * (cameraX + 1.777/2 + 0.65), -1 * (cameraY + 0.65), 0.0f));
+    renderState.SetViewMatrix(texturedProgram, viewMatrix);
+    renderState.SetProjectionMatrix(texturedProgram, projectionMatrix);
+    renderState.SetViewMatrix(program, viewMatrix);
+    renderState.SetProjectionMatrix(program, projectionMatrix);
+
+    renderState.Clear();
+    renderState.UseProgram(texturedProgram);
+
+    //draw level
+    renderState.SetModelMatrix(texturedProgram, glm::mat4(1.0f));
+    {
+        PROFILE_ZONE("tilemap");
+        tileMapRenderer.Update(projectionMatrix, viewMatrix);
+        tileMapRenderer.Draw(texturedProgram, sheetTexture);
+    }
+
+    //player, key, enemies and coins that are on screen
+    float viewLeft = cameraX + 1.777f/2 + 0.65f - 1.777f;
+    float viewRight = viewLeft + 2 * 1.777f;
+    float viewBottom = cameraY + 0.65f - 1.0f;
+    float viewTop = viewBottom + 2.0f;
+    for(int i = 0; i < (int)snapshot.sprites.size(); i++) {
+        const SnapshotSprite &sprite = snapshot.sprites[i];
+        float x = lerp(sprite.previousX, sprite.x, alpha);
+        float y = lerp(sprite.previousY, sprite.y, alpha);
+        if(x + sprite.width < viewLeft || x - sprite.width > viewRight ||
+           y + sprite.height < viewBottom || y - sprite.height > viewTop) {
+            continue;
+        }
+        sprites.DrawSheetSprite(sheetTexture, x, y, sprite.width, sprite.height, sprite.spriteIndex, 16, 8);
+    }
+    {
+        PROFILE_ZONE("sprites");
+        sprites.SetMatrices(projectionMatrix, viewMatrix);
+        sprites.Flush();
+    }
+}
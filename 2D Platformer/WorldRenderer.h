@@ -0,0 +1,20 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+
+#include "ShaderProgram.h"
+#include "GameState.h"
+#include "TileMapRenderer.h"
+#include "SpriteInstancer.h"
+#include "glm/mat4x4.hpp"
+
+// Draws one frame of the level from a snapshot: tiles, then the on-screen
+// sprites, interpolated alpha of the way from the previous simulation step
+// to the snapshot's, with the camera following the player. Reads nothing but
+// the snapshot, so it can run while the simulation thread moves on. Shared
+// by the game and the render check so both draw exactly the same thing.
+void DrawWorld(const RenderSnapshot &snapshot, float alpha, ShaderProgram &program, ShaderProgram &texturedProgram, GLuint sheetTexture,
+               const glm::mat4 &projectionMatrix, TileMapRenderer &tileMapRenderer, SpriteInstancer &sprites);
@@ -0,0 +1,72 @@
+#include "AudioCheck.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+
+// how often the check plays the sound, like a rally with quick returns
+#define AUDIO_CHECK_HIT_MS 150
+
+int RunAudioCheck(const char *soundFile, const char *musicFile, int seconds, int bufferFrames, const char *driver) {
+
+    AudioEngine audio;
+    if(!audio.Open(bufferFrames, driver)) {
+        return 1;
+    }
+    int sound = audio.LoadSound(soundFile);
+    if(sound < 0 || !audio.PlayMusic(musicFile)) {
+        return 1;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int hits = 0, bursts = 0;
+    while(true) {
+        int elapsed = (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        if(elapsed >= seconds * 1000) { break; }
+
+        if(elapsed >= hits * AUDIO_CHECK_HIT_MS) {
+            audio.Play(sound, 1);
+            hits++;
+        }
+        //more low priority sounds than there are voices; they steal from each
+        //other but never from the hits
+        if(elapsed >= bursts * 1000) {
+            for(int i = 0; i < AUDIO_MAX_VOICES + 4; i++) {
+                audio.Play(sound, 0, 0.25f);
+            }
+            bursts++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    AudioStats stats = audio.Stats();
+    int frames = audio.BufferFrames();
+    audio.Close();
+
+    double bufferMicroseconds = frames * 1000000.0 / AUDIO_RATE;
+    double worstMicroseconds = stats.worstCallbackNanoseconds / 1000.0;
+    printf("\naudio check: %d s on the %s driver, %d frame buffer (%.1f ms)\n", seconds, driver, frames, bufferMicroseconds / 1000.0);
+    printf("  %llu callbacks, %llu frames mixed (%.0f expected)\n", (unsigned long long)stats.callbacks,
+           (unsigned long long)stats.framesMixed, (double)seconds * AUDIO_RATE);
+    printf("  worst callback %.1f us of %.1f us\n", worstMicroseconds, bufferMicroseconds);
+    printf("  %d hits and %d bursts played, %llu voices stolen, %llu plays dropped\n", hits, bursts,
+           (unsigned long long)stats.voicesStolen, (unsigned long long)stats.playsDropped);
+    printf("  %llu music frames missed\n", (unsigned long long)stats.musicUnderruns);
+
+    bool passed = stats.callbacks > 0 && stats.musicUnderruns == 0 && worstMicroseconds < bufferMicroseconds;
+    printf("  %s\n", passed ? "ok" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+#ifdef AUDIO_CHECK_MAIN
+// needs SDL but no window, GPU or sound card; see README
+int main(int argc, char *argv[]) {
+    if(argc < 3) {
+        printf("usage: %s sound.wav music.wav [seconds] [buffer frames] [driver]\n", argv[0]);
+        return 1;
+    }
+    return RunAudioCheck(argv[1], argv[2], argc > 3 ? atoi(argv[3]) : 10,
+                         argc > 4 ? atoi(argv[4]) : AUDIO_DEFAULT_BUFFER_FRAMES, argc > 5 ? argv[5] : "dummy");
+}
+#endif
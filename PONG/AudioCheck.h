@@ -0,0 +1,13 @@
+#pragma once
+
+#include "AudioEngine.h"
+
+// Opens the named SDL audio driver ("dummy" mixes in real time and throws
+// the result away, "disk" also writes it to sdlaudio.raw), streams the music
+// and plays the sound at paddle-hit pace for seconds, with a burst past the
+// voice pool every second so voices get stolen. Prints the mixer counters
+// and fails if the music stream ever fell behind or a callback took longer
+// than the audio it produced. Needs no sound card. Returns the process exit
+// code.
+int RunAudioCheck(const char *soundFile, const char *musicFile, int seconds,
+                  int bufferFrames = AUDIO_DEFAULT_BUFFER_FRAMES, const char *driver = "dummy");
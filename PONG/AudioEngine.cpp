@@ -0,0 +1,330 @@
+#include "AudioEngine.h"
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+
+// voice and music volumes are fixed point, this is full volume
+#define AUDIO_VOLUME_ONE 256
+
+// frames decoded per read when loading a sound effect
+#define AUDIO_LOAD_FRAMES 4096
+
+AudioEngine::AudioEngine() : device(0), bufferFrames(0), voiceClock(0), commandHead(0), commandTail(0),
+                             musicWrite(0), musicRead(0), musicVolume(AUDIO_VOLUME_ONE), musicPlaying(false), musicEnded(false),
+                             streamStopping(false), musicLoop(false), callbacks(0), framesMixed(0), musicUnderruns(0),
+                             voicesStolen(0), playsDropped(0), worstCallbackNanoseconds(0) {
+    for(int i = 0; i < AUDIO_MAX_VOICES; i++) {
+        voices[i].sound = NULL;
+    }
+}
+
+AudioEngine::~AudioEngine() {
+    Close();
+    for(int i = 0; i < (int)sounds.size(); i++) {
+        delete sounds[i];
+    }
+}
+
+bool AudioEngine::Open(int frames, const char *driver) {
+    Close();
+
+    //SDL reads the driver name when the audio subsystem starts
+    if(driver) {
+        SDL_setenv("SDL_AUDIODRIVER", driver, 1);
+    }
+    if(SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
+        printf("audio: %s\n", SDL_GetError());
+        return false;
+    }
+
+    SDL_AudioSpec wanted;
+    memset(&wanted, 0, sizeof(wanted));
+    wanted.freq = AUDIO_RATE;
+    wanted.format = AUDIO_S16SYS;
+    wanted.channels = 2;
+    wanted.samples = (Uint16)frames;
+    wanted.callback = Callback;
+    wanted.userdata = this;
+
+    //no changes allowed: SDL converts to whatever the hardware takes
+    SDL_AudioSpec obtained;
+    device = SDL_OpenAudioDevice(NULL, 0, &wanted, &obtained, 0);
+    if(device == 0) {
+        printf("audio: %s\n", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+
+    //everything the callback touches is allocated before it first runs
+    bufferFrames = obtained.samples;
+    mixBuffer.assign(bufferFrames * 2, 0);
+    SDL_PauseAudioDevice(device, 0);
+    return true;
+}
+
+void AudioEngine::Close() {
+    StopMusic();
+    if(device == 0) { return; }
+
+    //returns once the callback has finished for good
+    SDL_CloseAudioDevice(device);
+    device = 0;
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+
+    for(int i = 0; i < AUDIO_MAX_VOICES; i++) {
+        voices[i].sound = NULL;
+    }
+    commandTail.store(commandHead.load());
+}
+
+int AudioEngine::LoadSound(const char *fileName) {
+
+    WavDecoder decoder;
+    if(!decoder.Open(fileName)) {
+        printf("audio: unable to load %s\n", fileName);
+        return -1;
+    }
+
+    Sound *sound = new Sound();
+    int frames = 0;
+    while(true) {
+        sound->samples.resize((frames + AUDIO_LOAD_FRAMES) * 2);
+        int read = decoder.Read(&sound->samples[frames * 2], AUDIO_LOAD_FRAMES, AUDIO_RATE);
+        frames += read;
+        if(read < AUDIO_LOAD_FRAMES) { break; }
+    }
+    //the mixer reads from the first sample on, so an empty sound is no sound
+    if(frames == 0) {
+        printf("audio: %s has no audio in it\n", fileName);
+        delete sound;
+        return -1;
+    }
+    sound->samples.resize(frames * 2);
+    sound->frames = frames;
+
+    //the callback looks sounds up by index; keep it out while the list grows
+    if(device) { SDL_LockAudioDevice(device); }
+    sounds.push_back(sound);
+    if(device) { SDL_UnlockAudioDevice(device); }
+    return (int)sounds.size() - 1;
+}
+
+bool AudioEngine::Play(int sound, int priority, float volume) {
+    if(device == 0 || sound < 0 || sound >= (int)sounds.size()) { return false; }
+
+    uint32_t head = commandHead.load(std::memory_order_relaxed);
+    if(head - commandTail.load(std::memory_order_acquire) >= AUDIO_COMMAND_SLOTS) {
+        playsDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    PlayCommand command = { sound, priority, (int)(volume * AUDIO_VOLUME_ONE) };
+    commands[head % AUDIO_COMMAND_SLOTS] = command;
+    commandHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool AudioEngine::PlayMusic(const char *fileName, bool loop) {
+    StopMusic();
+    if(!musicDecoder.Open(fileName)) {
+        printf("audio: unable to load %s\n", fileName);
+        return false;
+    }
+
+    musicLoop = loop;
+    musicRing.resize(AUDIO_MUSIC_RING_FRAMES * 2);
+    musicBlock.resize(AUDIO_MUSIC_BLOCK_FRAMES * 2);
+    musicWrite.store(0);
+    musicRead.store(0);
+    musicEnded.store(false);
+
+    //the ring starts full, so the first callbacks never wait on the thread
+    FillMusic();
+    streamStopping.store(false);
+    musicPlaying.store(true, std::memory_order_release);
+    streamThread = std::thread(&AudioEngine::StreamLoop, this);
+    return true;
+}
+
+void AudioEngine::StopMusic() {
+    if(streamThread.joinable()) {
+        streamStopping.store(true);
+        streamThread.join();
+    }
+    musicPlaying.store(false, std::memory_order_release);
+
+    //wait out a callback that may still be reading the ring
+    if(device) {
+        SDL_LockAudioDevice(device);
+        SDL_UnlockAudioDevice(device);
+    }
+    musicDecoder.Close();
+}
+
+void AudioEngine::SetMusicVolume(float volume) {
+    musicVolume.store((int)(volume * AUDIO_VOLUME_ONE), std::memory_order_relaxed);
+}
+
+AudioStats AudioEngine::Stats() const {
+    AudioStats stats;
+    stats.callbacks = callbacks.load(std::memory_order_relaxed);
+    stats.framesMixed = framesMixed.load(std::memory_order_relaxed);
+    stats.musicUnderruns = musicUnderruns.load(std::memory_order_relaxed);
+    stats.voicesStolen = voicesStolen.load(std::memory_order_relaxed);
+    stats.playsDropped = playsDropped.load(std::memory_order_relaxed);
+    stats.worstCallbackNanoseconds = worstCallbackNanoseconds.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AudioEngine::FillMusic() {
+    //whole blocks only; the ring is a multiple of the block size
+    while(!musicEnded.load(std::memory_order_relaxed)) {
+        uint32_t write = musicWrite.load(std::memory_order_relaxed);
+        if(AUDIO_MUSIC_RING_FRAMES - (write - musicRead.load(std::memory_order_acquire)) < AUDIO_MUSIC_BLOCK_FRAMES) {
+            return;
+        }
+
+        int frames = musicDecoder.Read(&musicBlock[0], AUDIO_MUSIC_BLOCK_FRAMES, AUDIO_RATE);
+        while(frames < AUDIO_MUSIC_BLOCK_FRAMES) {
+            if(!musicLoop) {
+                musicEnded.store(true, std::memory_order_relaxed);
+                break;
+            }
+            musicDecoder.Rewind();
+            int more = musicDecoder.Read(&musicBlock[frames * 2], AUDIO_MUSIC_BLOCK_FRAMES - frames, AUDIO_RATE);
+            if(more == 0) {
+                //nothing to loop over
+                musicEnded.store(true, std::memory_order_relaxed);
+                break;
+            }
+            frames += more;
+        }
+
+        for(int i = 0; i < frames; i++) {
+            uint32_t slot = (write + i) & (AUDIO_MUSIC_RING_FRAMES - 1);
+            musicRing[slot * 2] = musicBlock[i * 2];
+            musicRing[slot * 2 + 1] = musicBlock[i * 2 + 1];
+        }
+        musicWrite.store(write + frames, std::memory_order_release);
+    }
+}
+
+void AudioEngine::StreamLoop() {
+    while(!streamStopping.load()) {
+        FillMusic();
+        std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_STREAM_POLL_MS));
+    }
+}
+
+void AudioEngine::Callback(void *userdata, Uint8 *stream, int length) {
+    AudioEngine &engine = *(AudioEngine*)userdata;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    int frames = length / (2 * sizeof(int16_t));
+    engine.Mix((int16_t*)stream, frames);
+
+    uint64_t nanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    engine.callbacks.fetch_add(1, std::memory_order_relaxed);
+    engine.framesMixed.fetch_add(frames, std::memory_order_relaxed);
+    //the callback is the only writer
+    if(nanoseconds > engine.worstCallbackNanoseconds.load(std::memory_order_relaxed)) {
+        engine.worstCallbackNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+void AudioEngine::Mix(int16_t *out, int frames) {
+
+    //plays queued since the last buffer start at its top
+    uint32_t tail = commandTail.load(std::memory_order_relaxed);
+    uint32_t head = commandHead.load(std::memory_order_acquire);
+    for(; tail != head; tail++) {
+        StartVoice(commands[tail % AUDIO_COMMAND_SLOTS]);
+    }
+    commandTail.store(tail, std::memory_order_release);
+
+    //SDL may ask for more than one buffer's worth; mix it a buffer at a time
+    int capacity = (int)mixBuffer.size() / 2;
+    while(frames > 0) {
+        int chunk = frames < capacity ? frames : capacity;
+        int32_t *mix = &mixBuffer[0];
+        memset(mix, 0, chunk * 2 * sizeof(int32_t));
+
+        MixMusic(chunk);
+
+        for(int v = 0; v < AUDIO_MAX_VOICES; v++) {
+            Voice &voice = voices[v];
+            if(!voice.sound) { continue; }
+            int count = voice.sound->frames - voice.position;
+            if(count > chunk) { count = chunk; }
+            const int16_t *samples = &voice.sound->samples[voice.position * 2];
+            for(int i = 0; i < count * 2; i++) {
+                mix[i] += (samples[i] * voice.volume) / AUDIO_VOLUME_ONE;
+            }
+            voice.position += count;
+            if(voice.position >= voice.sound->frames) {
+                voice.sound = NULL;
+            }
+        }
+
+        for(int i = 0; i < chunk * 2; i++) {
+            int32_t sample = mix[i];
+            out[i] = (int16_t)(sample > 32767 ? 32767 : (sample < -32768 ? -32768 : sample));
+        }
+        out += chunk * 2;
+        frames -= chunk;
+    }
+}
+
+void AudioEngine::StartVoice(const PlayCommand &command) {
+
+    int chosen = -1;
+    for(int v = 0; v < AUDIO_MAX_VOICES; v++) {
+        if(!voices[v].sound) {
+            chosen = v;
+            break;
+        }
+    }
+
+    if(chosen < 0) {
+        //the lowest priority voice, oldest first, as long as it does not outrank the new one
+        for(int v = 0; v < AUDIO_MAX_VOICES; v++) {
+            const Voice &voice = voices[v];
+            if(voice.priority > command.priority) { continue; }
+            if(chosen < 0 || voice.priority < voices[chosen].priority ||
+               (voice.priority == voices[chosen].priority && voice.started < voices[chosen].started)) {
+                chosen = v;
+            }
+        }
+        if(chosen < 0) {
+            playsDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        voicesStolen.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Voice &voice = voices[chosen];
+    voice.sound = sounds[command.sound];
+    voice.position = 0;
+    voice.priority = command.priority;
+    voice.volume = command.volume;
+    voice.started = voiceClock++;
+}
+
+void AudioEngine::MixMusic(int frames) {
+    if(!musicPlaying.load(std::memory_order_acquire)) { return; }
+
+    uint32_t read = musicRead.load(std::memory_order_relaxed);
+    uint32_t available = musicWrite.load(std::memory_order_acquire) - read;
+    int count = available < (uint32_t)frames ? (int)available : frames;
+    if(count < frames && !musicEnded.load(std::memory_order_relaxed)) {
+        musicUnderruns.fetch_add(frames - count, std::memory_order_relaxed);
+    }
+
+    int volume = musicVolume.load(std::memory_order_relaxed);
+    int32_t *mix = &mixBuffer[0];
+    for(int i = 0; i < count; i++) {
+        uint32_t slot = (read + i) & (AUDIO_MUSIC_RING_FRAMES - 1);
+        mix[i * 2] += (musicRing[slot * 2] * volume) / AUDIO_VOLUME_ONE;
+        mix[i * 2 + 1] += (musicRing[slot * 2 + 1] * volume) / AUDIO_VOLUME_ONE;
+    }
+    musicRead.store(read + count, std::memory_order_release);
+}
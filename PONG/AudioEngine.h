@@ -0,0 +1,132 @@
+#pragma once
+
+#include <SDL.h>
+#include "WavDecoder.h"
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// the device always runs 16-bit stereo at this rate; SDL converts if the
+// hardware wants something else
+#define AUDIO_RATE 44100
+#define AUDIO_DEFAULT_BUFFER_FRAMES 512
+
+// sound effects playing at once; a new one past this steals a voice
+#define AUDIO_MAX_VOICES 16
+// plays queued between two callbacks; more than that are dropped
+#define AUDIO_COMMAND_SLOTS 64
+
+// music is decoded this many frames at a time into a ring this big (a
+// power of two, about a third of a second)
+#define AUDIO_MUSIC_BLOCK_FRAMES 2048
+#define AUDIO_MUSIC_RING_FRAMES 16384
+// how often the streaming thread looks for room in the ring
+#define AUDIO_STREAM_POLL_MS 10
+
+// counters kept by the mixer; read them from any thread
+struct AudioStats {
+    uint64_t callbacks;
+    uint64_t framesMixed;
+    // frames music should have played but the stream had not decoded yet
+    uint64_t musicUnderruns;
+    uint64_t voicesStolen;
+    uint64_t playsDropped;
+    uint64_t worstCallbackNanoseconds;
+};
+
+// Small SDL audio mixer: sound effects are decoded up front and played from
+// a fixed pool of voices, music is decoded a block at a time on its own
+// thread and streamed through a ring buffer. The mixer callback takes no
+// locks and allocates nothing; Play hands it work through a queue, so call
+// Play, PlayMusic and the rest from one thread (the main loop).
+//
+// A voice is stolen when the pool is full and the new sound's priority is at
+// least that of the lowest priority voice playing; the oldest of those goes.
+class AudioEngine {
+    public:
+
+        AudioEngine();
+        ~AudioEngine();
+
+        // opens the device with a buffer of bufferFrames (256-512 keeps the
+        // delay to a few milliseconds); driver picks an SDL audio driver by
+        // name, e.g. "dummy" or "disk" for machines without a sound card
+        bool Open(int bufferFrames = AUDIO_DEFAULT_BUFFER_FRAMES, const char *driver = NULL);
+        void Close();
+        int BufferFrames() const { return bufferFrames; }
+
+        // decodes the whole file; returns the sound to Play, or -1
+        int LoadSound(const char *fileName);
+        // higher priority wins when voices run out; false if it was dropped
+        bool Play(int sound, int priority = 0, float volume = 1.0f);
+
+        bool PlayMusic(const char *fileName, bool loop = true);
+        void StopMusic();
+        void SetMusicVolume(float volume);
+
+        AudioStats Stats() const;
+
+    private:
+
+        struct Sound {
+            std::vector<int16_t> samples;
+            int frames;
+        };
+
+        struct Voice {
+            const Sound *sound;
+            int position;
+            int priority;
+            int volume;
+            uint64_t started;
+        };
+
+        struct PlayCommand {
+            int sound;
+            int priority;
+            int volume;
+        };
+
+        static void Callback(void *userdata, Uint8 *stream, int length);
+        void Mix(int16_t *out, int frames);
+        void StartVoice(const PlayCommand &command);
+        void MixMusic(int frames);
+        void FillMusic();
+        void StreamLoop();
+
+        SDL_AudioDeviceID device;
+        int bufferFrames;
+        // 32-bit sums of one buffer, sized when the device opens
+        std::vector<int32_t> mixBuffer;
+
+        std::vector<Sound*> sounds;
+        Voice voices[AUDIO_MAX_VOICES];
+        uint64_t voiceClock;
+
+        // single producer (Play), single consumer (the callback)
+        PlayCommand commands[AUDIO_COMMAND_SLOTS];
+        std::atomic<uint32_t> commandHead;
+        std::atomic<uint32_t> commandTail;
+
+        // decoded music, stereo frames; write and read only ever grow
+        std::vector<int16_t> musicRing;
+        std::atomic<uint32_t> musicWrite;
+        std::atomic<uint32_t> musicRead;
+        std::atomic<int> musicVolume;
+        std::atomic<bool> musicPlaying;
+        // the file ran out and is not looping; what is left in the ring plays out
+        std::atomic<bool> musicEnded;
+        std::atomic<bool> streamStopping;
+        bool musicLoop;
+        WavDecoder musicDecoder;
+        std::vector<int16_t> musicBlock;
+        std::thread streamThread;
+
+        std::atomic<uint64_t> callbacks;
+        std::atomic<uint64_t> framesMixed;
+        std::atomic<uint64_t> musicUnderruns;
+        std::atomic<uint64_t> voicesStolen;
+        std::atomic<uint64_t> playsDropped;
+        std::atomic<uint64_t> worstCallbackNanoseconds;
+};
@@ -0,0 +1,297 @@
+#include "GameState.h"
+#include "Profiler.h"
+#include <cmath>
+#include <iostream>
+
+const char *simSubsystemNames[SUBSYSTEM_COUNT] = { "paddles", "scoring", "ball" };
+
+// what the ball reaches first in a sweep
+enum BallHit { HIT_NONE, HIT_WALL, HIT_LEFT_PADDLE, HIT_RIGHT_PADDLE };
+
+// narrows [enter, exit] to the times position + velocity * t is within extent
+// of 0 on one axis
+static bool clipSlab(float position, float velocity, float extent, float &enter, float &exit) {
+    if(velocity == 0.0f) {
+        return fabsf(position) <= extent;
+    }
+    float near = (-extent - position) / velocity;
+    float far = (extent - position) / velocity;
+    if(near > far) {
+        float swap = near;
+        near = far;
+        far = swap;
+    }
+    if(near > enter) { enter = near; }
+    if(far < exit) { exit = far; }
+    return enter <= exit;
+}
+
+// Earliest time within maxTime that a circle at (x, y) moving at (vx, vy)
+// touches a box. The circle's center is traced against the box grown by the
+// radius, with its corners rounded. A circle already touching counts at time
+// 0 if it is heading in.
+static bool sweepCircleBox(float x, float y, float vx, float vy, float radius,
+                           float boxX, float boxY, float halfWidth, float halfHeight, float maxTime, float &time) {
+    float px = x - boxX;
+    float py = y - boxY;
+    float growX = halfWidth + radius;
+    float growY = halfHeight + radius;
+    
+    float enter = 0.0f;
+    float exit = maxTime;
+    if(!clipSlab(px, vx, growX, enter, exit) || !clipSlab(py, vy, growY, enter, exit)) {
+        return false;
+    }
+    
+    //already touching: a hit only if moving against the contact normal, so a
+    //ball that just bounced off is let go
+    if(enter == 0.0f) {
+        float normalX = px - (px > halfWidth ? halfWidth : (px < -halfWidth ? -halfWidth : px));
+        float normalY = py - (py > halfHeight ? halfHeight : (py < -halfHeight ? -halfHeight : py));
+        if(normalX * normalX + normalY * normalY <= radius * radius) {
+            bool headingIn = (normalX == 0.0f && normalY == 0.0f) ? px * vx < 0.0f : normalX * vx + normalY * vy < 0.0f;
+            if(!headingIn) {
+                return false;
+            }
+            time = 0.0f;
+            return true;
+        }
+    }
+    
+    //along a face the grown box is the shape; past a corner, the corner's circle is
+    float hitX = px + vx * enter;
+    float hitY = py + vy * enter;
+    if(fabsf(hitX) > halfWidth && fabsf(hitY) > halfHeight) {
+        float mx = hitX - (hitX > 0.0f ? halfWidth : -halfWidth);
+        float my = hitY - (hitY > 0.0f ? halfHeight : -halfHeight);
+        float b = mx * vx + my * vy;
+        float c = mx * mx + my * my - radius * radius;
+        if(c > 0.0f) {
+            float a = vx * vx + vy * vy;
+            float discriminant = b * b - a * c;
+            if(b >= 0.0f || discriminant < 0.0f) {
+                return false;
+            }
+            enter += (-b - sqrtf(discriminant)) / a;
+            if(enter > maxTime) {
+                return false;
+            }
+        }
+    }
+    
+    time = enter;
+    return true;
+}
+
+GameState::GameState() {
+    
+    paddleHeight = 0.6;
+    paddleWidth = 0.1;
+    
+    leftPaddleX = -1.65 + (paddleWidth/2);
+    leftPaddleY = 0.0f;
+    
+    rightPaddleX = 1.6 + (paddleWidth/2);
+    rightPaddleY = 1.0f;
+    
+    speed = 1.5f;
+    
+    ballX = 0.0f;
+    ballY = 0.0f;
+    ballHeight = 0.1f;
+    ballWidth = 0.1f;
+    
+    dirX = 1.0f;
+    dirY = 0.0f;
+    ballSpeed = 1.0f;
+    
+    scorePlayer1 = 0;
+    scorePlayer2 = 0;
+    
+    winPlayer1 = false;
+    winPlayer2 = false;
+    
+    round = 1;
+    
+    rightColorR = 0.0f;
+    rightColorG = 0.8f;
+    rightColorB = 0.2f;
+    
+    leftColorR = 0.0f;
+    leftColorG = 0.8f;
+    leftColorB = 0.2f;
+    
+    paddleHits = 0;
+    totalPaddleHits = 0;
+}
+
+void GameState::Update(float timeElapsed, const PongInput &input) {
+    
+    timer.Start();
+    paddleHits = 0;
+    
+    // move the paddle with WASD keys within walls
+    if(input.leftUp) {
+        if (leftPaddleY + (paddleHeight/2) < 1.0f) { leftPaddleY += timeElapsed * speed; }
+    }
+    else if(input.leftDown) {
+        if (leftPaddleY - (paddleHeight/2) > -1.0f ){ leftPaddleY -= timeElapsed * speed;}
+    }
+    
+    // move the paddle with arrow keys within screen
+    if(input.rightUp) {
+        if (rightPaddleY + (paddleHeight/2) < 1.0f ) { rightPaddleY += timeElapsed * speed; }
+    }
+    else if(input.rightDown) {
+        if (rightPaddleY - (paddleHeight/2) > -1.0f){ rightPaddleY -= timeElapsed * speed;}
+    }
+    timer.Lap(SUBSYSTEM_PADDLES);
+    
+    //Keep score & bring the ball back if it leaves the screen
+    // right wall, left side score (P1)
+    if ( ballX + ballWidth > 2.0 ) {
+        ballX = 0.0f;
+        ballY = 0.0f;
+        scorePlayer1++;
+        std::cout << "PLAYER 1 SCORED!" << "\n" <<  "________________" << "\n" << "  SCOREBOARD" <<  "\n" <<"\n" << "PLAYER 1: " << scorePlayer1 <<  "\n" << "PLAYER 2: " << scorePlayer2 << "\n" << "\n" ;
+        
+        //reset color, break streak
+        rightColorR = 0.0;
+        rightColorB = 0.2;
+        
+    }
+    
+    //left wall, right side score (P2)
+    if ( ballX - ballWidth < -2.0 ) {
+        ballX = 0.0f;
+        ballY = 0.0f;
+        scorePlayer2++;
+        
+        std::cout << "PLAYER 2 SCORED!" << "\n" <<  "________________" << "\n" << "  SCOREBOARD" <<  "\n" << "\n" << "PLAYER 1: " << scorePlayer1 <<  "\n" << "PLAYER 2: " << scorePlayer2 << "\n" << "\n" ;
+        
+        //reset color, break streak
+        leftColorR = 0.0f;
+        leftColorB = 0.2f;
+    }
+    
+    
+    //check rounds & track wins
+    if (scorePlayer1 == 7 ){
+        winPlayer1 = true;
+        
+        //reset scores -- new round
+        scorePlayer1 = 0;
+        scorePlayer2 = 0;
+        
+        round++;
+        
+        
+        std::cout << "PLAYER 1 WINS!" << "\n";
+        std::cout << "  ROUND " << round << "\n" << "\n";
+    }
+    
+    if (scorePlayer2 == 7 ){
+        winPlayer2 = true;
+        
+        //reset scores -- new round
+        scorePlayer1 = 0;
+        scorePlayer2 = 0;
+        
+        std::cout << "PLAYER 2 WINS!" << "\n";
+        std::cout << "  ROUND " << round << "\n" << "\n";
+    }
+    timer.Lap(SUBSYSTEM_SCORING);
+    
+    MoveBall(timeElapsed);
+    timer.Lap(SUBSYSTEM_BALL);
+    
+    totalPaddleHits += paddleHits;
+}
+
+void GameState::MoveBall(float timeElapsed) {
+    
+    PROFILE_ZONE("collision");
+    float radius = ballWidth / 2;
+    float wallY = 1.0f - radius;
+    
+    float remaining = timeElapsed;
+    for(int bounce = 0; bounce < PONG_MAX_BOUNCES && remaining > 0.0f; bounce++) {
+        float vx = dirX * ballSpeed;
+        float vy = dirY * ballSpeed;
+        
+        //the first thing the ball reaches this tick, if anything
+        BallHit hit = HIT_NONE;
+        float first = remaining;
+        float time;
+        if(vy != 0.0f) {
+            time = ((vy > 0.0f ? wallY : -wallY) - ballY) / vy;
+            if(time < 0.0f) { time = 0.0f; }
+            if(time <= first) { first = time; hit = HIT_WALL; }
+        }
+        if(sweepCircleBox(ballX, ballY, vx, vy, radius, leftPaddleX, leftPaddleY, paddleWidth/2, paddleHeight/2, first, time)) {
+            first = time;
+            hit = HIT_LEFT_PADDLE;
+        }
+        if(sweepCircleBox(ballX, ballY, vx, vy, radius, rightPaddleX, rightPaddleY, paddleWidth/2, paddleHeight/2, first, time)) {
+            first = time;
+            hit = HIT_RIGHT_PADDLE;
+        }
+        
+        ballX += vx * first;
+        ballY += vy * first;
+        remaining -= first;
+        
+        if(hit == HIT_NONE) {
+            break;
+        }
+        if(hit == HIT_WALL) {
+            //bounce off top & bottom walls
+            dirY = ballY > 0.0f ? -fabsf(dirY) : fabsf(dirY);
+        }
+        else if(hit == HIT_LEFT_PADDLE) {
+            ReturnBall(leftPaddleY, 1.0f, leftColorR, leftColorB);
+        }
+        else {
+            ReturnBall(rightPaddleY, -1.0f, rightColorR, rightColorB);
+        }
+    }
+}
+
+void GameState::ReturnBall(float paddleY, float awayX, float &colorR, float &colorB) {
+    
+    dirX = awayX * fabsf(dirX);
+    
+    //if it hits the top of the paddle, hit it back upwards;
+    if (ballY > paddleY ) {dirY = 1.3;}
+    //if it hits the bottom of the paddle, hit it back downwards
+    if (ballY < paddleY ) {dirY = -1.3;}
+    //if it hits the center, hit it back with no y.change
+    if (ballY == paddleY) {dirY = 0;}
+    
+    //change color with each save -- streak representation
+    colorR += 0.2;
+    if (colorR > 1) {colorB += 0.1; if (colorB > 1) {colorR = 0;}if (colorR > 1 & colorB >1) {colorR = 0.0; colorB = 0.0;}}
+    
+    paddleHits++;
+}
+
+void GameState::WriteSnapshot(RenderSnapshot &snapshot) const {
+    
+    snapshot.paddleHeight = paddleHeight;
+    snapshot.leftPaddleY = leftPaddleY;
+    snapshot.rightPaddleY = rightPaddleY;
+    
+    snapshot.ballX = ballX;
+    snapshot.ballY = ballY;
+    snapshot.ballWidth = ballWidth;
+    snapshot.ballHeight = ballHeight;
+    
+    snapshot.leftColorR = leftColorR;
+    snapshot.leftColorG = leftColorG;
+    snapshot.leftColorB = leftColorB;
+    snapshot.rightColorR = rightColorR;
+    snapshot.rightColorG = rightColorG;
+    snapshot.rightColorB = rightColorB;
+    
+    snapshot.totalPaddleHits = totalPaddleHits;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "SimTimer.h"
+#include <stdint.h>
+
+// the simulation thread steps this often; game time runs 1.5x faster than
+// wall time, as it always has
+#define PONG_STEP (1.0/120.0)
+#define PONG_TIME_SCALE 1.5f
+
+// contacts the ball can resolve in one Update; time left after that is dropped
+#define PONG_MAX_BOUNCES 8
+
+// subsystems timed by the headless benchmark
+enum SimSubsystem { SUBSYSTEM_PADDLES, SUBSYSTEM_SCORING, SUBSYSTEM_BALL, SUBSYSTEM_COUNT };
+extern const char *simSubsystemNames[SUBSYSTEM_COUNT];
+
+// key state for one tick
+struct PongInput {
+    bool leftUp;
+    bool leftDown;
+    bool rightUp;
+    bool rightDown;
+};
+
+// Everything the renderer needs from one Update, copied out so drawing never
+// reads the GameState the simulation thread is changing. Positions are centers.
+struct RenderSnapshot {
+    float paddleHeight;
+    float leftPaddleY;
+    float rightPaddleY;
+    
+    float ballX;
+    float ballY;
+    float ballWidth;
+    float ballHeight;
+    
+    float leftColorR;
+    float leftColorG;
+    float leftColorB;
+    float rightColorR;
+    float rightColorG;
+    float rightColorB;
+    
+    // running total, so hits in steps the renderer never saw still get a sound
+    int totalPaddleHits;
+    // when the step was due, SimulationThread::Now time
+    uint64_t time;
+};
+
+// Everything Pong simulates, kept apart from SDL, GL and the mixer so it can
+// run without a window. Sound is left to the caller: Update reports how many
+// paddle hits happened in paddleHits.
+class GameState {
+public:
+    
+    GameState();
+    void Update(float timeElapsed, const PongInput &input);
+    
+    void WriteSnapshot(RenderSnapshot &snapshot) const;
+    
+    // Moves the ball through timeElapsed, bouncing off walls and paddles on
+    // the way. The ball is swept as a circle, so no speed or step size lets it
+    // pass through a paddle.
+    void MoveBall(float timeElapsed);
+    // sends the ball back from a paddle: away from it in x, up or down by
+    // where on the paddle it landed
+    void ReturnBall(float paddleY, float awayX, float &colorR, float &colorB);
+    
+    //paddle variables
+    float paddleHeight;
+    float paddleWidth;
+    
+    float leftPaddleX;
+    float leftPaddleY;
+    
+    float rightPaddleX;
+    float rightPaddleY;
+    
+    float speed;
+    
+    //ball variables
+    float ballX;
+    float ballY;
+    float ballHeight;
+    float ballWidth;
+    
+    // direction, scaled by ballSpeed
+    float dirX;
+    float dirY;
+    float ballSpeed;
+    
+    // score keeping
+    int scorePlayer1;
+    int scorePlayer2;
+    
+    bool winPlayer1;
+    bool winPlayer2;
+    
+    int round;
+    
+    float rightColorR;
+    float rightColorG;
+    float rightColorB;
+    
+    float leftColorR;
+    float leftColorG;
+    float leftColorB;
+    
+    // paddle hits during the last Update, and since the start
+    int paddleHits;
+    int totalPaddleHits;
+    
+    SimTimer timer;
+};
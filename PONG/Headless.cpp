@@ -0,0 +1,97 @@
+#include "Headless.h"
+#include "GameState.h"
+#include "Profiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+// same frame pacing as the windowed game at 60 Hz
+#define HEADLESS_TIMESTEP ((1.0f / 60.0f) * 1.5f)
+
+// deterministic input: both paddles chase the ball, the right one a little late
+static void ScriptInput(const GameState &state, PongInput &input) {
+    input.leftUp = state.ballY > state.leftPaddleY + 0.05f;
+    input.leftDown = state.ballY < state.leftPaddleY - 0.05f;
+    input.rightUp = state.ballY > state.rightPaddleY + 0.2f;
+    input.rightDown = state.ballY < state.rightPaddleY - 0.2f;
+}
+
+int RunHeadless(int ticks) {
+
+    GameState state;
+    state.timer.enabled = true;
+
+    PongInput input = { false, false, false, false };
+    int paddleHits = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int tick = 0; tick < ticks; tick++) {
+        ScriptInput(state, input);
+        state.Update(HEADLESS_TIMESTEP, input);
+        profiler.EndFrame();
+        paddleHits += state.paddleHits;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("\nheadless: %d ticks in %.4f s (%.0f ticks/s)\n", ticks, seconds, ticks / seconds);
+    for(int i = 0; i < SUBSYSTEM_COUNT; i++) {
+        printf("  %-10s %9.3f ms %9.3f us/tick\n", simSubsystemNames[i], state.timer.seconds[i] * 1000.0, state.timer.seconds[i] * 1000000.0 / ticks);
+    }
+    printf("  %d paddle hits, round %d, score %d-%d\n", paddleHits, state.round, state.scorePlayer1, state.scorePlayer2);
+
+    //zones inside the simulation, one frame per tick
+    profiler.Report();
+
+    return 0;
+}
+
+int RunTunnelCheck(float ballSpeed, float stepSeconds) {
+
+    PongInput none = { false, false, false, false };
+    int returned = 0;
+    int missed = 0;
+    for(int shot = 0; shot < TUNNEL_CHECK_SHOTS; shot++) {
+        GameState state;
+        state.ballSpeed = ballSpeed;
+        state.rightPaddleY = 0.0f;
+
+        //start heights spread over the middle of the court, aimed anywhere on
+        //the paddle's face
+        float fraction = (float)((shot * 7) % TUNNEL_CHECK_SHOTS) / (TUNNEL_CHECK_SHOTS - 1);
+        float reach = state.paddleHeight / 2;
+        float targetY = -reach + 2.0f * reach * fraction;
+        state.ballY = -0.5f + (float)shot / (TUNNEL_CHECK_SHOTS - 1);
+        state.dirY = (targetY - state.ballY) / (state.rightPaddleX - state.paddleWidth / 2 - state.ballWidth / 2 - state.ballX);
+
+        //long enough to cross the court a few times over
+        int ticks = 100 + (int)(10.0f / (ballSpeed * stepSeconds));
+        for(int tick = 0; tick < ticks; tick++) {
+            state.Update(stepSeconds, none);
+            if(state.paddleHits > 0) {
+                returned++;
+                break;
+            }
+            if(state.scorePlayer1 > 0) {
+                missed++;
+                break;
+            }
+        }
+    }
+
+    printf("\ntunnel check: %d shots at speed %.1f, ball moves %.3f per step against a %.2f wide paddle\n",
+           TUNNEL_CHECK_SHOTS, ballSpeed, ballSpeed * stepSeconds, GameState().paddleWidth);
+    printf("  %d returned, %d went through\n", returned, missed);
+    return missed == 0 && returned == TUNNEL_CHECK_SHOTS ? 0 : 1;
+}
+
+#ifdef HEADLESS_MAIN
+// build without SDL, GL or SDL_mixer for GPU-less boxes:
+// c++ -DHEADLESS_MAIN Headless.cpp GameState.cpp Profiler.cpp
+int main(int argc, char *argv[]) {
+    if(argc > 1 && strcmp(argv[1], "--tunnel-check") == 0) {
+        return RunTunnelCheck(argc > 2 ? (float)atof(argv[2]) : 40.0f, argc > 3 ? (float)atof(argv[3]) : HEADLESS_TIMESTEP);
+    }
+    return RunHeadless(argc > 1 ? atoi(argv[1]) : 100000);
+}
+#endif
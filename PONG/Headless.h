@@ -0,0 +1,14 @@
+#pragma once
+
+#define TUNNEL_CHECK_SHOTS 1000
+
+// Runs the simulation for the given number of ticks with scripted input and
+// no window, GL context or audio device, then prints simulation ticks per
+// second and the time spent in each subsystem. Returns the process exit code.
+int RunHeadless(int ticks);
+
+// Fires the ball at a still paddle from TUNNEL_CHECK_SHOTS heights and
+// angles that should all hit it, at ballSpeed with one Update per stepSeconds
+// of game time, and counts any that get through. Returns the process exit
+// code: 1 if one did.
+int RunTunnelCheck(float ballSpeed, float stepSeconds);
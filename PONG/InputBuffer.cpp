@@ -0,0 +1,84 @@
+#include "InputBuffer.h"
+#include "SimulationThread.h"
+
+InputBuffer::InputBuffer() : lastRecorded(0) {
+    for(int scancode = 0; scancode < INPUT_MAX_SCANCODES; scancode++) {
+        bindings[scancode] = INPUT_UNBOUND;
+    }
+    for(int action = 0; action < INPUT_MAX_ACTIONS; action++) {
+        recordedDown[action] = false;
+        held[action] = false;
+        wasHeld[action] = false;
+        pressed[action] = 0;
+        released[action] = 0;
+    }
+    InputStats none = { 0, 0, 0 };
+    stats = none;
+}
+
+void InputBuffer::Bind(int scancode, int action) {
+    if(scancode < 0 || scancode >= INPUT_MAX_SCANCODES || action < 0 || action >= INPUT_MAX_ACTIONS) { return; }
+    bindings[scancode] = action;
+}
+
+void InputBuffer::KeyEvent(int scancode, bool down, uint32_t eventMilliseconds, uint32_t nowMilliseconds) {
+    if(scancode < 0 || scancode >= INPUT_MAX_SCANCODES || bindings[scancode] == INPUT_UNBOUND) { return; }
+
+    //how long ago the key moved; unsigned so it survives SDL_GetTicks wrapping
+    uint32_t age = nowMilliseconds - eventMilliseconds;
+    if((int32_t)age < 0) {
+        age = 0;
+    }
+    uint64_t now = SimulationThread::Now();
+    uint64_t ageNanoseconds = (uint64_t)age * 1000000;
+    Record(bindings[scancode], down, ageNanoseconds < now ? now - ageNanoseconds : 0);
+}
+
+void InputBuffer::Record(int action, bool down, uint64_t time) {
+    if(action < 0 || action >= INPUT_MAX_ACTIONS || recordedDown[action] == down) { return; }
+    recordedDown[action] = down;
+
+    //whole millisecond ages taken against a nanosecond clock can step back by
+    //up to a millisecond when SDL's tick rolls over between two events
+    if(time < lastRecorded) {
+        time = lastRecorded;
+    }
+    lastRecorded = time;
+
+    InputEvent event = { time, action, down };
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(event);
+}
+
+void InputBuffer::Advance(uint64_t time) {
+    for(int action = 0; action < INPUT_MAX_ACTIONS; action++) {
+        wasHeld[action] = held[action];
+        pressed[action] = 0;
+        released[action] = 0;
+    }
+
+    uint64_t now = SimulationThread::Now();
+    std::lock_guard<std::mutex> lock(mutex);
+    //stamps never go backwards, so everything this tick owns is at the front
+    while(!queue.empty() && queue.front().time <= time) {
+        const InputEvent &event = queue.front();
+        held[event.action] = event.down;
+        if(event.down) {
+            pressed[event.action]++;
+            uint64_t latency = now > event.time ? now - event.time : 0;
+            stats.presses++;
+            stats.totalLatencyNanoseconds += latency;
+            if(latency > stats.worstLatencyNanoseconds) {
+                stats.worstLatencyNanoseconds = latency;
+            }
+        } else {
+            released[event.action]++;
+        }
+        queue.pop_front();
+    }
+}
+
+InputStats InputBuffer::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
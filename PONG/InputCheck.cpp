@@ -0,0 +1,89 @@
+#include "InputCheck.h"
+#include "InputBuffer.h"
+#include <stdint.h>
+#include <cstdio>
+
+// one 60 Hz step in nanoseconds, and an arbitrary time to start from
+#define INPUT_CHECK_STEP 16666667ull
+#define INPUT_CHECK_START 1000000000ull
+#define INPUT_CHECK_ACTION 0
+
+static int failedChecks;
+
+static void Expect(bool passed, const char *what) {
+    printf("  %-56s %s\n", what, passed ? "ok" : "FAILED");
+    if(!passed) {
+        failedChecks++;
+    }
+}
+
+int RunInputCheck() {
+
+    const uint64_t step = INPUT_CHECK_STEP;
+    const uint64_t start = INPUT_CHECK_START;
+    const int action = INPUT_CHECK_ACTION;
+    failedChecks = 0;
+    printf("\ninput check\n");
+
+    //down and up between two steps, shorter than a frame
+    {
+        InputBuffer inputs;
+        inputs.Advance(start);
+        inputs.Record(action, true, start + step / 4);
+        inputs.Record(action, false, start + step / 2);
+        inputs.Advance(start + step);
+        Expect(inputs.Pressed(action) == 1 && inputs.Released(action) == 1, "a tap inside one step is one press");
+        Expect(inputs.Down(action) && !inputs.Held(action), "the tap counts as down for that step");
+        inputs.Advance(start + 2 * step);
+        Expect(inputs.Pressed(action) == 0 && !inputs.Down(action), "and is gone the step after");
+    }
+
+    //held down, with the key repeating
+    {
+        InputBuffer inputs;
+        inputs.Advance(start);
+        inputs.Record(action, true, start + step / 4);
+        inputs.Record(action, true, start + step / 2);
+        inputs.Advance(start + step);
+        Expect(inputs.Pressed(action) == 1 && inputs.Held(action), "a repeat in the same step is dropped");
+        inputs.Record(action, true, start + step + step / 2);
+        inputs.Advance(start + 2 * step);
+        Expect(inputs.Pressed(action) == 0 && inputs.Held(action), "a repeat in a later step is no new press");
+        inputs.Record(action, false, start + 2 * step + step / 2);
+        inputs.Record(action, true, start + 2 * step + 3 * step / 4);
+        inputs.Advance(start + 3 * step);
+        Expect(inputs.Pressed(action) == 1 && inputs.Released(action) == 1, "a release and press again is a new press");
+    }
+
+    //a press just after a step is due waits for the next one
+    {
+        InputBuffer inputs;
+        inputs.Record(action, true, start + step + 1);
+        inputs.Advance(start + step);
+        Expect(inputs.Pressed(action) == 0 && !inputs.Down(action), "a press after a step is not seen by it");
+        inputs.Advance(start + 2 * step);
+        Expect(inputs.Pressed(action) == 1, "but by the step after");
+    }
+
+    //a stamp that steps back, as when SDL's millisecond tick rolls over
+    //between two events, still lands after the one recorded before it
+    {
+        InputBuffer inputs;
+        inputs.Record(action, true, start + step + 600000);
+        inputs.Record(action, false, start + step - 300000);
+        inputs.Advance(start + step);
+        Expect(inputs.Pressed(action) == 0 && inputs.Released(action) == 0, "transitions apply in the order they were recorded");
+        inputs.Advance(start + 2 * step);
+        Expect(inputs.Pressed(action) == 1 && inputs.Released(action) == 1 && !inputs.Held(action), "both land on the same step");
+    }
+
+    printf("  %s\n", failedChecks ? "FAILED" : "ok");
+    return failedChecks ? 1 : 0;
+}
+
+#ifdef INPUT_CHECK_MAIN
+// c++ -DINPUT_CHECK_MAIN InputCheck.cpp InputBuffer.cpp SimulationThread.cpp -pthread
+int main() {
+    return RunInputCheck();
+}
+#endif
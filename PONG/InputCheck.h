@@ -0,0 +1,8 @@
+#pragma once
+
+// Feeds scripted key transitions through an InputBuffer with Record and
+// checks what the steps see: a tap shorter than a step is still one press and
+// counts as down for that step, key repeats are dropped, so a held key is one
+// press (one jump or shot) however long it is held, and a press lands on the
+// step it came before. Needs no window or SDL. Returns the process exit code.
+int RunInputCheck();
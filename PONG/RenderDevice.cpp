@@ -0,0 +1,122 @@
+#include "RenderDevice.h"
+
+const char *renderCommandNames[RENDER_COMMAND_COUNT] = {
+    "clear", "use program", "bind texture", "bind buffer",
+    "enable attribute", "disable attribute", "attribute pointer",
+    "attribute divisor", "uniform", "create buffer", "delete buffer",
+    "buffer data", "draw", "draw instanced"
+};
+
+RecordingRenderDevice::RecordingRenderDevice(bool supportsInstancing) : nextBuffer(1), instancing(supportsInstancing) {
+    Reset();
+}
+
+void RecordingRenderDevice::Reset() {
+    commands.clear();
+    for(int i = 0; i < RENDER_COMMAND_COUNT; i++) {
+        counts[i] = 0;
+    }
+    drawCalls = 0;
+    vertices = 0;
+    instances = 0;
+    stateChanges = 0;
+    bufferBytes = 0;
+}
+
+void RecordingRenderDevice::Add(RenderCommandType type, GLuint target, GLint first, GLsizei count, GLsizei instances) {
+    RenderCommand command = { type, target, first, count, instances };
+    commands.push_back(command);
+    counts[type]++;
+    switch(type) {
+        case RENDER_USE_PROGRAM:
+        case RENDER_BIND_TEXTURE:
+        case RENDER_BIND_BUFFER:
+        case RENDER_ENABLE_ATTRIBUTE:
+        case RENDER_DISABLE_ATTRIBUTE:
+        case RENDER_ATTRIBUTE_DIVISOR:
+        case RENDER_UNIFORM:
+            stateChanges++;
+            break;
+        default:
+            break;
+    }
+}
+
+void RecordingRenderDevice::Clear() {
+    Add(RENDER_CLEAR, 0);
+}
+
+void RecordingRenderDevice::UseProgram(GLuint program) {
+    Add(RENDER_USE_PROGRAM, program);
+}
+
+void RecordingRenderDevice::BindTexture(GLuint texture) {
+    Add(RENDER_BIND_TEXTURE, texture);
+}
+
+void RecordingRenderDevice::BindArrayBuffer(GLuint buffer) {
+    Add(RENDER_BIND_BUFFER, buffer);
+}
+
+void RecordingRenderDevice::SetAttributeEnabled(GLuint attribute, bool enabled) {
+    Add(enabled ? RENDER_ENABLE_ATTRIBUTE : RENDER_DISABLE_ATTRIBUTE, attribute);
+}
+
+void RecordingRenderDevice::AttributePointer(GLuint attribute, GLsizei stride, const void * /*pointer*/, GLint /*size*/) {
+    Add(RENDER_ATTRIBUTE_POINTER, attribute, 0, stride);
+}
+
+void RecordingRenderDevice::UniformMatrix(GLint uniform, const float * /*matrix*/) {
+    Add(RENDER_UNIFORM, (GLuint)uniform);
+}
+
+void RecordingRenderDevice::UniformColor(GLint uniform, float /*r*/, float /*g*/, float /*b*/, float /*a*/) {
+    Add(RENDER_UNIFORM, (GLuint)uniform);
+}
+
+GLuint RecordingRenderDevice::CreateBuffer() {
+    GLuint buffer = nextBuffer++;
+    Add(RENDER_CREATE_BUFFER, buffer);
+    return buffer;
+}
+
+void RecordingRenderDevice::DeleteBuffers(GLsizei count, const GLuint *buffers) {
+    for(int i = 0; i < count; i++) {
+        Add(RENDER_DELETE_BUFFER, buffers[i]);
+    }
+}
+
+void RecordingRenderDevice::BufferData(size_t bytes, const void * /*data*/) {
+    Add(RENDER_BUFFER_DATA, 0, 0, (GLsizei)bytes);
+    bufferBytes += bytes;
+}
+
+void RecordingRenderDevice::StreamBufferData(size_t bytes, const void *data) {
+    BufferData(bytes, data);
+}
+
+void RecordingRenderDevice::DrawArrays(GLint first, GLsizei count) {
+    Add(RENDER_DRAW, 0, first, count);
+    drawCalls++;
+    vertices += count;
+}
+
+void RecordingRenderDevice::AttributeDivisor(GLuint attribute, GLuint divisor) {
+    Add(RENDER_ATTRIBUTE_DIVISOR, attribute, 0, divisor);
+}
+
+void RecordingRenderDevice::DrawArraysInstanced(GLint first, GLsizei count, GLsizei instanceCount) {
+    Add(RENDER_DRAW_INSTANCED, 0, first, count, instanceCount);
+    drawCalls++;
+    vertices += count * instanceCount;
+    instances += instanceCount;
+}
+
+void RecordingRenderDevice::Write(FILE *file) const {
+    for(int i = 0; i < (int)commands.size(); i++) {
+        const RenderCommand &command = commands[i];
+        fprintf(file, "%s %u %d %d %d\n", renderCommandNames[command.type], command.target, command.first, command.count, command.instances);
+    }
+    fprintf(file, "# %d draw calls, %d vertices, %d instances, %d state changes, %lu buffer bytes\n",
+            drawCalls, vertices, instances, stateChanges, (unsigned long)bufferBytes);
+}
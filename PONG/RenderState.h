@@ -0,0 +1,109 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+#include <stdint.h>
+
+#include "ShaderProgram.h"
+#include "RenderDevice.h"
+#include "glm/mat4x4.hpp"
+
+// programs whose uniforms are tracked; more than this are still set, just
+// never skipped
+#define RENDER_STATE_MAX_PROGRAMS 8
+
+// vertex attributes tracked, the minimum GL guarantees
+#define RENDER_STATE_ATTRIBUTES 16
+
+// Shadows the GL state the games touch every frame (current program, bound
+// texture and array buffer, enabled vertex attributes and each program's
+// matrices and color) and skips calls that would not change anything. What
+// is left goes to the current RenderDevice, which has to be set before the
+// first draw: glRenderDevice in the games, a RecordingRenderDevice in checks.
+//
+// Everything that draws has to go through it: ShaderProgram's own Set*
+// functions call glUseProgram behind its back, so use the versions here
+// instead. Call Invalidate after deleting textures, or after any code that
+// changes this state directly.
+class RenderState {
+    public:
+
+        RenderState();
+
+        // also forgets the cached state, which belonged to the old device
+        void SetDevice(RenderDevice *device);
+        RenderDevice *Device() const { return device; }
+
+        void UseProgram(const ShaderProgram &program);
+        void BindTexture(GLuint texture);
+        void BindArrayBuffer(GLuint buffer);
+
+        // enables exactly these attributes and disables the rest; pass -1
+        // (or an attribute the program does not have) to leave one out
+        void UseAttributes(GLint position, GLint texCoord = -1);
+        // same with bit n for attribute n; attributes in instanced advance
+        // once per instance instead of once per vertex, which needs a device
+        // that SupportsInstancing
+        void UseAttributeMask(uint32_t enabled, uint32_t instanced = 0);
+        // 0 for -1 or attributes past RENDER_STATE_ATTRIBUTES
+        static uint32_t AttributeBit(GLint attribute);
+
+        // these also make the program current
+        void SetModelMatrix(const ShaderProgram &program, const glm::mat4 &matrix);
+        void SetViewMatrix(const ShaderProgram &program, const glm::mat4 &matrix);
+        void SetProjectionMatrix(const ShaderProgram &program, const glm::mat4 &matrix);
+        void SetColor(const ShaderProgram &program, float r, float g, float b, float a);
+
+        // not cached, just passed on to the device
+        void Clear();
+        void AttributePointer(GLuint attribute, GLsizei stride, const void *pointer, GLint size = 2);
+        void DrawArrays(GLint first, GLsizei count);
+        bool SupportsInstancing();
+        void DrawArraysInstanced(GLint first, GLsizei count, GLsizei instances);
+        GLuint CreateBuffer();
+        void DeleteBuffers(GLsizei count, const GLuint *buffers);
+        void BufferData(size_t bytes, const void *data);
+        void StreamBufferData(size_t bytes, const void *data);
+
+        void Invalidate();
+
+        // GL calls made and elided since the last ResetCounters
+        uint64_t issuedCalls;
+        uint64_t skippedCalls;
+        void ResetCounters() { issuedCalls = 0; skippedCalls = 0; }
+
+    private:
+
+        struct ProgramUniforms {
+            GLuint programID;
+            bool hasModel, hasView, hasProjection, hasColor;
+            glm::mat4 model;
+            glm::mat4 view;
+            glm::mat4 projection;
+            float color[4];
+        };
+
+        ProgramUniforms *Uniforms(const ShaderProgram &program);
+        bool SetMatrix(GLuint uniform, bool &has, glm::mat4 &cached, const glm::mat4 &matrix);
+
+        RenderDevice *device;
+
+        bool hasProgram;
+        GLuint currentProgram;
+        bool hasTexture;
+        GLuint currentTexture;
+        bool hasArrayBuffer;
+        GLuint currentArrayBuffer;
+        // bit n set when attribute n is enabled
+        uint32_t enabledAttributes;
+        bool attributesKnown;
+        // bit n set when attribute n has a divisor of 1
+        uint32_t instancedAttributes;
+
+        ProgramUniforms programs[RENDER_STATE_MAX_PROGRAMS];
+        int programCount;
+};
+
+extern RenderState renderState;
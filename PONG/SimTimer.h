@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+
+#define SIM_TIMER_SLOTS 8
+
+// Accumulates wall time per simulation subsystem. Start() marks the beginning
+// of a tick and every Lap(slot) charges the time since the previous mark to
+// that slot. Does nothing unless enabled, so the windowed game pays one branch.
+class SimTimer {
+    public:
+
+        SimTimer() : enabled(false) { Reset(); }
+
+        void Reset() {
+            for(int i = 0; i < SIM_TIMER_SLOTS; i++) { seconds[i] = 0.0; }
+        }
+
+        void Start() {
+            if(enabled) { mark = std::chrono::steady_clock::now(); }
+        }
+
+        void Lap(int slot) {
+            if(!enabled) { return; }
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            seconds[slot] += std::chrono::duration<double>(now - mark).count();
+            mark = now;
+        }
+
+        bool enabled;
+        double seconds[SIM_TIMER_SLOTS];
+
+    private:
+
+        std::chrono::steady_clock::time_point mark;
+};
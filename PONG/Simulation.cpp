@@ -0,0 +1,39 @@
+#include "Simulation.h"
+#include "Profiler.h"
+
+Simulation::Simulation(GameState &gameState) : state(gameState) {
+
+}
+
+Simulation::~Simulation() {
+    Stop();
+}
+
+void Simulation::Begin(double stepSeconds, int maxSteps) {
+    //so the renderer has something to draw before the first step lands
+    RenderSnapshot &snapshot = snapshots.WriteSlot();
+    state.WriteSnapshot(snapshot);
+    snapshot.time = Now();
+    snapshots.Publish();
+    Start(stepSeconds, maxSteps);
+}
+
+void Simulation::Step(uint64_t time) {
+    //a tap between two steps still moves the paddle for one
+    inputs.Advance(time);
+    PongInput input;
+    input.leftUp = inputs.Down(ACTION_LEFT_UP);
+    input.leftDown = inputs.Down(ACTION_LEFT_DOWN);
+    input.rightUp = inputs.Down(ACTION_RIGHT_UP);
+    input.rightDown = inputs.Down(ACTION_RIGHT_DOWN);
+
+    {
+        PROFILE_ZONE("update");
+        state.Update((float)PONG_STEP * PONG_TIME_SCALE, input);
+    }
+
+    RenderSnapshot &snapshot = snapshots.WriteSlot();
+    state.WriteSnapshot(snapshot);
+    snapshot.time = time;
+    snapshots.Publish();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "GameState.h"
+#include "InputBuffer.h"
+#include "SimulationThread.h"
+#include "SnapshotBuffer.h"
+
+// what the keys are bound to
+enum PongAction { ACTION_LEFT_UP, ACTION_LEFT_DOWN, ACTION_RIGHT_UP, ACTION_RIGHT_DOWN };
+
+// Runs Pong's GameState on its own thread, one Update every PONG_STEP. The
+// main thread passes key events to inputs, draws the newest snapshot and plays the
+// hit sounds it reports; the GameState itself belongs to the simulation
+// thread until Stop returns.
+class Simulation : public SimulationThread {
+    public:
+
+        Simulation(GameState &gameState);
+        ~Simulation();
+
+        // publishes a snapshot of the current state, then starts stepping;
+        // stepSeconds 0 runs flat out (see SimulationThread::Start)
+        void Begin(double stepSeconds = PONG_STEP, int maxSteps = 0);
+
+        InputBuffer inputs;
+        SnapshotBuffer<RenderSnapshot> snapshots;
+
+    protected:
+
+        void Step(uint64_t time);
+
+    private:
+
+        GameState &state;
+};
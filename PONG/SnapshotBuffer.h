@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+
+#define SNAPSHOT_INDEX_MASK 3
+#define SNAPSHOT_FRESH 4
+
+// Hands whole snapshots from one producer thread to one consumer thread
+// without locks and without copying them. There are three slots: the
+// producer fills its own and Publish swaps it with the shared middle one;
+// Acquire swaps the middle one into the consumer's slot if anything was
+// published since. Neither side ever waits, the consumer always gets the
+// newest complete snapshot, and ones it never saw are simply written over.
+//
+// Slots are reused, so the producer has to overwrite every field each time;
+// vectors keep their capacity and stop allocating after the first few.
+template <typename T>
+class SnapshotBuffer {
+    public:
+
+        SnapshotBuffer() : writeIndex(0), readIndex(1), middle(2) {}
+
+        // producer side
+        T &WriteSlot() { return slots[writeIndex]; }
+
+        void Publish() {
+            int previous = middle.exchange(writeIndex | SNAPSHOT_FRESH, std::memory_order_acq_rel);
+            writeIndex = previous & SNAPSHOT_INDEX_MASK;
+        }
+
+        // consumer side; true if ReadSlot now holds something new
+        bool Acquire() {
+            if(!(middle.load(std::memory_order_acquire) & SNAPSHOT_FRESH)) { return false; }
+            int previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+            readIndex = previous & SNAPSHOT_INDEX_MASK;
+            return true;
+        }
+
+        const T &ReadSlot() const { return slots[readIndex]; }
+
+    private:
+
+        T slots[3];
+        int writeIndex;
+        int readIndex;
+        // index of the middle slot, plus SNAPSHOT_FRESH until it is acquired
+        std::atomic<int> middle;
+};
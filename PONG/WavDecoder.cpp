@@ -0,0 +1,132 @@
+#include "WavDecoder.h"
+#include <cstring>
+
+static uint32_t readLittle32(const unsigned char *bytes) {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint16_t readLittle16(const unsigned char *bytes) {
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+WavDecoder::WavDecoder() : file(NULL), channels(0), rate(0), bytesPerSample(0), dataOffset(0), dataBytes(0), bytesLeft(0),
+                           blockFrames(0), blockPosition(0), haveA(false), haveB(false), fraction(0) {
+}
+
+WavDecoder::~WavDecoder() {
+    Close();
+}
+
+bool WavDecoder::Open(const char *fileName) {
+    Close();
+    file = fopen(fileName, "rb");
+    if(!file) { return false; }
+
+    unsigned char header[12];
+    if(fread(header, 1, 12, file) != 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        Close();
+        return false;
+    }
+
+    //walk the chunks until "data"; "fmt " comes before it
+    bool haveFormat = false;
+    unsigned char chunk[8];
+    while(fread(chunk, 1, 8, file) == 8) {
+        uint32_t size = readLittle32(chunk + 4);
+        if(memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            unsigned char format[16];
+            if(fread(format, 1, 16, file) != 16) { break; }
+            int encoding = readLittle16(format);
+            channels = readLittle16(format + 2);
+            rate = (int)readLittle32(format + 4);
+            bytesPerSample = readLittle16(format + 14) / 8;
+            haveFormat = encoding == 1 && (channels == 1 || channels == 2) && (bytesPerSample == 1 || bytesPerSample == 2) && rate > 0;
+            fseek(file, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        }
+        else if(memcmp(chunk, "data", 4) == 0) {
+            if(!haveFormat) { break; }
+            dataOffset = ftell(file);
+            dataBytes = size;
+            block.resize(WAV_READ_FRAMES * channels * bytesPerSample);
+            Rewind();
+            return true;
+        }
+        else {
+            //chunks are padded to an even size
+            fseek(file, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    Close();
+    return false;
+}
+
+void WavDecoder::Close() {
+    if(file) {
+        fclose(file);
+        file = NULL;
+    }
+    haveA = false;
+    haveB = false;
+}
+
+void WavDecoder::Rewind() {
+    if(!file) { return; }
+    fseek(file, dataOffset, SEEK_SET);
+    bytesLeft = dataBytes;
+    blockFrames = 0;
+    blockPosition = 0;
+    fraction = 0;
+    haveA = NextFrame(frameA);
+    haveB = haveA && NextFrame(frameB);
+}
+
+bool WavDecoder::NextFrame(int16_t *frame) {
+    if(blockPosition == blockFrames) {
+        int frameBytes = channels * bytesPerSample;
+        uint32_t wanted = (uint32_t)block.size() < bytesLeft ? (uint32_t)block.size() : bytesLeft;
+        size_t got = fread(&block[0], 1, wanted, file);
+        bytesLeft -= (uint32_t)got;
+        blockFrames = (int)(got / frameBytes);
+        blockPosition = 0;
+        if(blockFrames == 0) {
+            bytesLeft = 0;
+            return false;
+        }
+    }
+
+    const unsigned char *source = &block[blockPosition * channels * bytesPerSample];
+    for(int channel = 0; channel < channels; channel++) {
+        //8-bit wav is unsigned, 16-bit is signed little endian
+        frame[channel] = bytesPerSample == 1 ? (int16_t)((source[channel] - 128) * 256) : (int16_t)readLittle16(source + channel * 2);
+    }
+    if(channels == 1) {
+        frame[1] = frame[0];
+    }
+    blockPosition++;
+    return true;
+}
+
+int WavDecoder::Read(int16_t *out, int frames, int outputRate) {
+    uint32_t step = (uint32_t)(((uint64_t)rate << 16) / outputRate);
+    int written = 0;
+    while(written < frames && haveA) {
+        //the last frame has nothing after it to blend towards
+        for(int channel = 0; channel < 2; channel++) {
+            int32_t a = frameA[channel];
+            int32_t b = haveB ? frameB[channel] : a;
+            out[written * 2 + channel] = (int16_t)(a + (int32_t)(((int64_t)(b - a) * fraction) >> 16));
+        }
+        written++;
+
+        fraction += step;
+        while(fraction >= 0x10000 && haveA) {
+            fraction -= 0x10000;
+            frameA[0] = frameB[0];
+            frameA[1] = frameB[1];
+            haveA = haveB;
+            haveB = haveA && NextFrame(frameB);
+        }
+    }
+    return written;
+}
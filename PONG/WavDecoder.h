@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstdio>
+#include <vector>
+
+// source frames read from the file at a time
+#define WAV_READ_FRAMES 1024
+
+// Reads an uncompressed PCM .wav (8 or 16 bit, mono or stereo) a block at a
+// time and hands it out as 16-bit stereo at whatever rate the caller asks
+// for, resampling linearly. Used whole for sound effects and block by block
+// for streamed music.
+class WavDecoder {
+    public:
+
+        WavDecoder();
+        ~WavDecoder();
+
+        bool Open(const char *fileName);
+        void Close();
+        // back to the first frame, for looping
+        void Rewind();
+
+        // writes up to frames stereo frames at outputRate; fewer means the
+        // file ended
+        int Read(int16_t *out, int frames, int outputRate);
+
+        int SourceRate() const { return rate; }
+
+    private:
+
+        bool NextFrame(int16_t *frame);
+
+        FILE *file;
+        int channels;
+        int rate;
+        int bytesPerSample;
+        long dataOffset;
+        uint32_t dataBytes;
+        uint32_t bytesLeft;
+
+        std::vector<unsigned char> block;
+        int blockFrames;
+        int blockPosition;
+
+        // resampler: output sits between frames a and b, fraction of the way
+        // there in 16.16 fixed point
+        int16_t frameA[2];
+        int16_t frameB[2];
+        bool haveA;
+        bool haveB;
+        uint32_t fraction;
+};
@@ -0,0 +1,237 @@
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <SDL_image.h>
+
+#include "ShaderProgram.h"
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION //required for stb image library
+#include "stb_image.h"
+
+#ifdef _WINDOWS
+#define RESOURCE_FOLDER
+#else
+#define RESOURCE_FOLDER "NYUCodebase.app/Contents/Resources/"
+#endif
+
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+#include "GameState.h"
+#include "Headless.h"
+#include "AudioEngine.h"
+#include "AudioCheck.h"
+#include "InputCheck.h"
+#include "Profiler.h"
+#include "RenderState.h"
+#include "Simulation.h"
+
+SDL_Window* displayWindow;
+
+int main(int argc, char *argv[])
+{
+    //benchmark the simulation alone: no window, no GL context, no audio
+    if(argc > 2 && strcmp(argv[1], "--headless") == 0) {
+        return RunHeadless(atoi(argv[2]));
+    }
+    //--tunnel-check [ball speed] [step seconds] fires the ball at a paddle far
+    //faster than it is played
+    if(argc > 1 && strcmp(argv[1], "--tunnel-check") == 0) {
+        return RunTunnelCheck(argc > 2 ? (float)atof(argv[2]) : 40.0f, argc > 3 ? (float)atof(argv[3]) : (float)PONG_STEP * PONG_TIME_SCALE);
+    }
+    //--audio-check [seconds] [buffer frames] [driver] mixes without a sound card
+    if(argc > 1 && strcmp(argv[1], "--audio-check") == 0) {
+        return RunAudioCheck(RESOURCE_FOLDER "blip.wav", RESOURCE_FOLDER "pongmusic.wav", argc > 2 ? atoi(argv[2]) : 10,
+                             argc > 3 ? atoi(argv[3]) : AUDIO_DEFAULT_BUFFER_FRAMES, argc > 4 ? argv[4] : "dummy");
+    }
+    //--input-check feeds scripted key transitions through the input buffer
+    if(argc > 1 && strcmp(argv[1], "--input-check") == 0) {
+        return RunInputCheck();
+    }
+    //--trace file.json [frames] records the first frames for chrome://tracing
+    if(argc > 2 && strcmp(argv[1], "--trace") == 0) {
+        profiler.StartCapture(argv[2], argc > 3 ? atoi(argv[3]) : PROFILER_CAPTURE_FRAMES);
+    }
+    
+    //--audio-buffer frames anywhere trades latency against dropouts
+    int audioBufferFrames = AUDIO_DEFAULT_BUFFER_FRAMES;
+    for(int i = 1; i + 1 < argc; i++) {
+        if(strcmp(argv[i], "--audio-buffer") == 0) {
+            audioBufferFrames = atoi(argv[i + 1]);
+        }
+    }
+    
+    SDL_Init(SDL_INIT_VIDEO);
+    displayWindow = SDL_CreateWindow("My Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 640, 360, SDL_WINDOW_OPENGL);
+    SDL_GLContext context = SDL_GL_CreateContext(displayWindow);
+    SDL_GL_MakeCurrent(displayWindow, context);
+    
+#ifdef _WINDOWS
+    glewInit();
+#endif
+    
+    //SETUP
+    glViewport(0, 0, 640, 360);
+    
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    //all drawing goes through the state cache to the real GL device
+    renderState.SetDevice(&glRenderDevice);
+    
+    ShaderProgram program;
+    ShaderProgram texturedProgram;
+    program.Load(RESOURCE_FOLDER"vertex.glsl", RESOURCE_FOLDER"fragment.glsl");
+    texturedProgram.Load(RESOURCE_FOLDER"vertex_textured.glsl", RESOURCE_FOLDER"fragment_textured.glsl");
+    
+    glm::mat4 projectionMatrix = glm::mat4(1.0f);
+    glm::mat4 modelMatrix = glm::mat4(1.0f);
+    glm::mat4 viewMatrix = glm::mat4(1.0f);
+    
+    projectionMatrix = glm::ortho(-1.777f, 1.777f, -1.0f, 1.0f, -1.0f, 1.0f);
+    
+    //background color
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    
+    GameState state;
+    
+    
+    //a small buffer keeps the blip within a few milliseconds of the hit; music
+    //streams from disk instead of sitting decoded in memory
+    AudioEngine audio;
+    audio.Open(audioBufferFrames);
+    int paddleHitSound = audio.LoadSound( RESOURCE_FOLDER "blip.wav");
+    
+    
+    //PLAY MUSIC
+    audio.PlayMusic( RESOURCE_FOLDER "pongmusic.wav" );
+    audio.SetMusicVolume(3.0f / 128.0f);
+    
+    //the game runs on its own fixed step from here on; this thread draws
+    //snapshots and plays the hits they report
+    Simulation simulation(state);
+    simulation.inputs.Bind(SDL_SCANCODE_W, ACTION_LEFT_UP);
+    simulation.inputs.Bind(SDL_SCANCODE_S, ACTION_LEFT_DOWN);
+    simulation.inputs.Bind(SDL_SCANCODE_UP, ACTION_RIGHT_UP);
+    simulation.inputs.Bind(SDL_SCANCODE_DOWN, ACTION_RIGHT_DOWN);
+    simulation.Begin();
+    int playedPaddleHits = 0;
+    
+    //GAME LOOP
+    SDL_Event event;
+    bool done = false;
+    while (!done) {
+        ProfileZone inputZone("input");
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT || event.type == SDL_WINDOWEVENT_CLOSE) {
+                done = true;
+            } else if(event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) {
+                //stamped with when the key moved, applied on the step it moved before
+                simulation.inputs.KeyEvent(event.key.keysym.scancode, event.type == SDL_KEYDOWN, event.key.timestamp, SDL_GetTicks());
+            }
+        }
+        inputZone.End();
+        
+        //the newest finished step; the same one again if none landed since
+        simulation.snapshots.Acquire();
+        const RenderSnapshot &snapshot = simulation.snapshots.ReadSlot();
+        
+        //play hit sound
+        for(; playedPaddleHits < snapshot.totalPaddleHits; playedPaddleHits++) {
+            audio.Play(paddleHitSound, 1);
+        }
+        
+        ProfileZone drawZone("draw");
+        renderState.Clear();
+        renderState.UseProgram(program);
+        
+        //LEFT PADDLE
+        renderState.SetColor(program, snapshot.leftColorR, snapshot.leftColorG, snapshot.leftColorB, 1.0f);
+        
+        float leftPaddlePosY = snapshot.leftPaddleY + (snapshot.paddleHeight/2);
+        float leftPaddleNegY = snapshot.leftPaddleY - (snapshot.paddleHeight/2);
+        
+        modelMatrix = glm::mat4(1.0f);
+        
+        renderState.SetModelMatrix(program, modelMatrix);
+        renderState.SetProjectionMatrix(program, projectionMatrix);
+        renderState.SetViewMatrix(program, viewMatrix);
+        
+        float vertices[] = {-1.7, leftPaddleNegY, -1.6, leftPaddleNegY, -1.6, leftPaddlePosY, -1.7, leftPaddleNegY, -1.6, leftPaddlePosY, -1.7, leftPaddlePosY};
+        renderState.AttributePointer(program.positionAttribute, 0, vertices);
+        renderState.UseAttributes(program.positionAttribute);
+        
+        renderState.DrawArrays(0, 6);
+        
+        
+        //RIGHT PADDLE
+        renderState.SetColor(program, snapshot.rightColorR, snapshot.rightColorG, snapshot.rightColorB, 1.0f);
+        
+        float rightPaddlePosY = snapshot.rightPaddleY + (snapshot.paddleHeight/2);
+        float rightPaddleNegY = snapshot.rightPaddleY - (snapshot.paddleHeight/2);
+        
+        modelMatrix = glm::mat4(1.0f);
+        
+        renderState.SetModelMatrix(program, modelMatrix);
+        renderState.SetProjectionMatrix(program, projectionMatrix);
+        renderState.SetViewMatrix(program, viewMatrix);
+        
+        float vertices2[] = { 1.7,rightPaddleNegY , 1.6, rightPaddleNegY, 1.6, rightPaddlePosY, 1.7, rightPaddleNegY,1.6, rightPaddlePosY, 1.7, rightPaddlePosY};
+        renderState.AttributePointer(program.positionAttribute, 0, vertices2);
+        renderState.UseAttributes(program.positionAttribute);
+        
+        renderState.DrawArrays(0, 6);
+        
+        //BALL
+        renderState.SetColor(program, 15.0f, 15.0f, 15.0f, 1.0f);
+        
+        modelMatrix = glm::mat4(1.0f);
+        
+        renderState.SetModelMatrix(program, modelMatrix);
+        renderState.SetProjectionMatrix(program, projectionMatrix);
+        renderState.SetViewMatrix(program, viewMatrix);
+        
+        float ballPosX = snapshot.ballX + (snapshot.ballWidth/2);
+        float ballNegX = snapshot.ballX - (snapshot.ballWidth/2);
+        
+        float ballPosY = snapshot.ballY + (snapshot.ballHeight/2);
+        float ballNegY = snapshot.ballY - (snapshot.ballHeight/2);
+        
+        float vertices3[] = {ballNegX, ballNegY,ballPosX, ballNegY, ballPosX, ballPosY, ballNegX, ballNegY, ballPosX, ballPosY, ballNegX, ballPosY};
+        renderState.AttributePointer(program.positionAttribute, 0, vertices3);
+        renderState.UseAttributes(program.positionAttribute);
+        
+        renderState.DrawArrays(0, 6);
+        
+        /////////////////////////////////
+        drawZone.End();
+        
+        ProfileZone swapZone("swap");
+        SDL_GL_SwapWindow(displayWindow);
+        swapZone.End();
+        
+        profiler.EndFrame();
+    }
+    
+    simulation.Stop();
+    InputStats inputStats = simulation.inputs.Stats();
+    if(inputStats.presses > 0) {
+        printf("input: %llu presses, %.2f ms mean and %.2f ms worst from key to step\n",
+               (unsigned long long)inputStats.presses, inputStats.totalLatencyNanoseconds / (inputStats.presses * 1000000.0),
+               inputStats.worstLatencyNanoseconds / 1000000.0);
+    }
+    profiler.StopCapture();
+    profiler.Report();
+    printf("render state: %llu GL calls made, %llu skipped as redundant\n", (unsigned long long)renderState.issuedCalls, (unsigned long long)renderState.skippedCalls);
+    
+    audio.Close();
+    SDL_Quit();
+    return 0;
+}
+
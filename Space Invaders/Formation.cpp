@@ -0,0 +1,177 @@
+#include "Formation.h"
+#include "GameState.h"
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+
+bool LoadWaves(const char *fileName, std::vector<WaveLayout> &waves) {
+
+    std::ifstream infile(fileName);
+    if(infile.fail()) {
+        return false;
+    }
+
+    std::vector<WaveLayout> loaded;
+    std::string line;
+    while(getline(infile, line)) {
+        if(line.empty() || line[0] == '#') { continue; }
+        if(line == "[wave]") {
+            WaveLayout wave = { 1, 1, 0.4f, 0.2f, 0.0f, 0.0f, 0.2f, MOVE_NONE, 0.0f, 0.0f };
+            loaded.push_back(wave);
+            continue;
+        }
+        if(loaded.empty()) { continue; }
+
+        std::istringstream sStream(line);
+        std::string key, value;
+        getline(sStream, key, '=');
+        getline(sStream, value);
+
+        WaveLayout &wave = loaded.back();
+        if(key == "rows") { wave.rows = std::max(1, atoi(value.c_str())); }
+        else if(key == "columns") { wave.columns = std::max(1, atoi(value.c_str())); }
+        else if(key == "spacingX") { wave.spacingX = (float)atof(value.c_str()); }
+        else if(key == "spacingY") { wave.spacingY = (float)atof(value.c_str()); }
+        else if(key == "x") { wave.x = (float)atof(value.c_str()); }
+        else if(key == "y") { wave.y = (float)atof(value.c_str()); }
+        else if(key == "size") { wave.size = (float)atof(value.c_str()); }
+        else if(key == "movement") { wave.movement = value == "sweep" ? MOVE_SWEEP : MOVE_NONE; }
+        else if(key == "speed") { wave.speed = (float)atof(value.c_str()); }
+        else if(key == "drop") { wave.drop = (float)atof(value.c_str()); }
+    }
+
+    if(loaded.empty()) {
+        return false;
+    }
+    waves.swap(loaded);
+    return true;
+}
+
+Formation::Formation() : offsetX(0.0f), offsetY(0.0f), direction(1.0f), aliveCount(0), extentsDirty(false), minLocalX(0.0f), maxLocalX(0.0f) {
+    WaveLayout empty = { 0, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, MOVE_NONE, 0.0f, 0.0f };
+    layout = empty;
+}
+
+void Formation::Start(const WaveLayout &newLayout) {
+
+    layout = newLayout;
+    offsetX = layout.x;
+    offsetY = layout.y;
+    direction = 1.0f;
+
+    int slots = SlotCount();
+    alive.assign((slots + 31) / 32, 0xFFFFFFFFu);
+    if(slots % 32) {
+        alive.back() = (1u << (slots % 32)) - 1;
+    }
+    aliveCount = slots;
+
+    //slots never move relative to each other, so they go in the grid once,
+    //about one slot per cell
+    float width = (layout.columns - 1) * layout.spacingX;
+    float height = (layout.rows - 1) * layout.spacingY;
+    float cellSize = std::max(layout.size, std::max(layout.spacingX, layout.spacingY));
+    grid.Setup(-layout.size, -layout.size, width + layout.size, height + layout.size, cellSize);
+    grid.Clear();
+    grid.Resize(slots);
+    for(int slot = 0; slot < slots; slot++) {
+        float x, y;
+        LocalPosition(slot, x, y);
+        grid.Update(slot, x, y, layout.size, layout.size);
+    }
+
+    extentsDirty = true;
+}
+
+void Formation::LocalPosition(int slot, float &x, float &y) const {
+    x = (slot % layout.columns) * layout.spacingX;
+    y = (slot / layout.columns) * layout.spacingY;
+}
+
+void Formation::SlotPosition(int slot, float &x, float &y) const {
+    LocalPosition(slot, x, y);
+    x += offsetX;
+    y += offsetY;
+}
+
+void Formation::Kill(int slot) {
+    if(!IsAlive(slot)) { return; }
+    alive[slot / 32] &= ~(1u << (slot % 32));
+    aliveCount--;
+    grid.Remove(slot);
+    extentsDirty = true;
+}
+
+void Formation::UpdateExtents() {
+    //only after a kill, and only the columns matter
+    int firstColumn = layout.columns, lastColumn = -1;
+    for(int slot = 0; slot < SlotCount(); slot++) {
+        if(IsAlive(slot)) {
+            int column = slot % layout.columns;
+            firstColumn = std::min(firstColumn, column);
+            lastColumn = std::max(lastColumn, column);
+        }
+    }
+    minLocalX = firstColumn * layout.spacingX;
+    maxLocalX = lastColumn * layout.spacingX;
+    extentsDirty = false;
+}
+
+void Formation::Update(float elapsed, float minX, float maxX) {
+
+    if(layout.movement != MOVE_SWEEP || aliveCount == 0) { return; }
+
+    if(extentsDirty) {
+        UpdateExtents();
+    }
+
+    //classic sweep: slide until the outermost live column reaches an edge, then drop and turn
+    offsetX += direction * layout.speed * elapsed;
+    float half = layout.size / 2;
+    if(direction > 0.0f && offsetX + maxLocalX + half > maxX) {
+        offsetX = maxX - maxLocalX - half;
+        offsetY -= layout.drop;
+        direction = -1.0f;
+    }
+    else if(direction < 0.0f && offsetX + minLocalX - half < minX) {
+        offsetX = minX - minLocalX + half;
+        offsetY -= layout.drop;
+        direction = 1.0f;
+    }
+}
+
+int Formation::HitTest(float x, float y, float width, float height) {
+
+    float localX = x - offsetX;
+    float localY = y - offsetY;
+
+    candidates.clear();
+    grid.Query(localX, localY, width, height, candidates);
+    for(int i = 0; i < (int)candidates.size(); i++) {
+        float slotX, slotY;
+        LocalPosition(candidates[i], slotX, slotY);
+        if(checkCollision(localX, localY, width, height, slotX, slotY, layout.size, layout.size)) {
+            return candidates[i];
+        }
+    }
+    return -1;
+}
+
+int Formation::HitTest(float x, float y, float width, float height, std::vector<int> &scratch) const {
+
+    float localX = x - offsetX;
+    float localY = y - offsetY;
+
+    //repeats come after an item's first listing, so the first hit is the same one
+    scratch.clear();
+    grid.QueryShared(localX, localY, width, height, scratch);
+    for(int i = 0; i < (int)scratch.size(); i++) {
+        float slotX, slotY;
+        LocalPosition(scratch[i], slotX, slotY);
+        if(checkCollision(localX, localY, width, height, slotX, slotY, layout.size, layout.size)) {
+            return scratch[i];
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+#include "SpatialGrid.h"
+
+enum FormationMovement { MOVE_NONE, MOVE_SWEEP };
+
+// One wave as read from waves.txt. Slot (row, column) sits at
+// (x + column * spacingX, y + row * spacingY) before the formation moves;
+// rows count upwards. Sizes and distances are world units, speed is per second.
+struct WaveLayout {
+    int rows;
+    int columns;
+    float spacingX;
+    float spacingY;
+    float x;
+    float y;
+    float size;
+    FormationMovement movement;
+    float speed;
+    float drop;
+};
+
+// Reads [wave] blocks of key=value lines, like the FlareMap text format.
+// Returns false (and leaves waves alone) if the file is missing or has no waves.
+bool LoadWaves(const char *fileName, std::vector<WaveLayout> &waves);
+
+// A wave of invaders stored as one offset plus an alive bit per slot. Moving
+// the whole wave is a single offset change; world positions are only worked
+// out for the slots being drawn or hit. Collision runs in formation space:
+// slots are put into a SpatialGrid once per wave and shots are moved into
+// that space for the query, so the grid never changes while the wave moves.
+class Formation {
+    public:
+
+        Formation();
+
+        void Start(const WaveLayout &layout);
+        void Update(float elapsed, float minX, float maxX);
+
+        int SlotCount() const { return layout.rows * layout.columns; }
+        int AliveCount() const { return aliveCount; }
+        bool IsAlive(int slot) const { return (alive[slot / 32] >> (slot % 32)) & 1; }
+        void Kill(int slot);
+
+        // world space center of a slot
+        void SlotPosition(int slot, float &x, float &y) const;
+        float SlotSize() const { return layout.size; }
+
+        // first live slot overlapping the box, or -1
+        int HitTest(float x, float y, float width, float height);
+        // the same answer without touching the formation, for jobs; scratch
+        // belongs to the caller
+        int HitTest(float x, float y, float width, float height, std::vector<int> &scratch) const;
+
+        // one bit per slot, 32 slots a word
+        const std::vector<uint32_t> &AliveBits() const { return alive; }
+
+        float offsetX;
+        float offsetY;
+        float direction;
+
+    private:
+
+        void LocalPosition(int slot, float &x, float &y) const;
+        void UpdateExtents();
+
+        WaveLayout layout;
+        std::vector<uint32_t> alive;
+        int aliveCount;
+
+        // live columns, local x of the outermost slot centers
+        bool extentsDirty;
+        float minLocalX;
+        float maxLocalX;
+
+        SpatialGrid grid;
+        std::vector<int> candidates;
+};
@@ -0,0 +1,223 @@
+#include "GameState.h"
+#include "JobSystem.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <cmath>
+
+const char *simSubsystemNames[SUBSYSTEM_COUNT] = { "formation", "enemy fire", "player", "bullets", "snapshot" };
+
+bool checkCollision(float x1, float y1, float w1, float h1, float x2, float y2, float w2, float h2) {
+
+    float  distanceX = fabsf(x1 - x2) - ((w1 + w2)/2);
+    float  distanceY = fabsf(y1 - y2) - ((h1 + h2)/2);
+
+    if(distanceX < 0 && distanceY < 0) { return true; }
+    else{ return false; }
+}
+
+Entity::Entity () : xPos(0), yPos(0), health(0.0f), rotation(0.0f) {
+    
+}
+
+GameState::GameState() {
+    
+    mode = STATE_MAIN_MENU;
+    
+    //initialize player at center
+    player.xPos = 0.0f;
+    player.yPos = -4.0f;
+    
+    //the original two rows of five, used when there is no waves file
+    WaveLayout wave = { 2, 5, 0.4f, 0.2f, -0.85f, 0.3f, 0.2f, MOVE_NONE, 0.0f, 0.0f };
+    waves.push_back(wave);
+    StartWave(0);
+    
+    enemyFireCooldown = 0;
+    
+    Seed(1);
+}
+
+void GameState::Seed(uint64_t newSeed) {
+    seed = newSeed;
+    for(int i = 0; i < RANDOM_STREAM_COUNT; i++) {
+        random[i].Seed(seed, i);
+    }
+}
+
+bool GameState::LoadWaves(const char *fileName) {
+    if(!::LoadWaves(fileName, waves)) {
+        LOG_WARN("Unable to load waves from %s\n", fileName);
+        return false;
+    }
+    StartWave(0);
+    return true;
+}
+
+void GameState::StartWave(int index) {
+    waveIndex = index % waves.size();
+    formation.Start(waves[waveIndex]);
+}
+
+// movement stage over a range of shots
+static void moveShots(void *data, int begin, int end) {
+    ((ProjectilePool*)data)->Move(INVADERS_TICK, begin, end);
+}
+
+// broad and narrow phase for a range of shots, against the formation as it
+// stood when the stage started; nothing is killed here
+static void hitTestShots(void *data, int begin, int end) {
+    static thread_local std::vector<int> scratch;
+    GameState &state = *(GameState*)data;
+    const ProjectilePool &projectiles = state.projectiles;
+    for(int i = begin; i < end; i++) {
+        float bulletSize = projectiles.size[i];
+        state.shotHits[i] = projectiles.owner[i] != OWNER_PLAYER ? -1 :
+                            state.formation.HitTest(projectiles.x[i], projectiles.y[i], bulletSize, bulletSize, scratch);
+    }
+}
+
+void GameState::Update(const InvadersInput &input) {
+    
+    timer.Start();
+    
+    if(mode == STATE_MAIN_MENU) {
+        if(input.start) {
+            mode = STATE_GAME_LEVEL;
+        }
+    }
+    
+    if(mode != STATE_GAME_LEVEL) {
+        return;
+    }
+    
+    //cleared waves roll over to the next one
+    if(formation.AliveCount() == 0) {
+        StartWave(waveIndex + 1);
+    }
+    formation.Update(INVADERS_TICK, -1.777f, 1.777f);
+    timer.Lap(SUBSYSTEM_FORMATION);
+    
+    int randomNumber = random[RANDOM_ENEMY_FIRE].Range(formation.SlotCount());
+    if(enemyFireCooldown > 0) {
+        enemyFireCooldown--;
+    }
+    else if(formation.IsAlive(randomNumber)) {
+        float x, y;
+        formation.SlotPosition(randomNumber, x, y);
+        projectiles.Fire(OWNER_ENEMY, x, y - formation.SlotSize()/2, 0.0f, -ENEMY_SHOT_SPEED, ENEMY_SHOT_SIZE, ENEMY_SHOT_LIFETIME);
+        LOG_DEBUG("enemy slot %d fired\n", randomNumber);
+        enemyFireCooldown = ENEMY_FIRE_INTERVAL;
+    }
+    timer.Lap(SUBSYSTEM_ENEMY_FIRE);
+    
+    //move player
+    if(input.left) {
+        if(player.xPos > -7.7f) {
+            player.xPos -= 1.0f;
+        }
+    }
+    else if(input.right) {
+        if(player.xPos < 7.7f) {
+            player.xPos += 1.0f;
+        }
+    }
+    timer.Lap(SUBSYSTEM_PLAYER);
+    
+    // shoot bullets
+    if(input.fire) {
+        float x = PLAYER_SCALE * player.xPos;
+        float y = PLAYER_SCALE * player.yPos + PLAYER_SCALE/2;
+        projectiles.Fire(OWNER_PLAYER, x, y, 0.0f, BULLET_SPEED, BULLET_SIZE, BULLET_LIFETIME);
+    }
+    
+    //move every live shot and drop the ones that left the screen or expired
+    jobs.ParallelFor(moveShots, &projectiles, projectiles.Count(), SHOT_GRAIN);
+    projectiles.Cull(-1.777f, -1.0f, 1.777f, 1.0f);
+    
+    //player shots against the formation; a shot is spent on its first hit
+    ProfileZone collisionZone("collision");
+    shotHits.resize(projectiles.Count());
+    jobs.ParallelFor(hitTestShots, this, projectiles.Count(), SHOT_GRAIN);
+    //kills go in the old order; killing only ever removes candidates, so a
+    //slot that is still alive is still the first hit
+    for(int i = projectiles.Count() - 1; i >= 0; i--) {
+        int slot = shotHits[i];
+        if(slot == -1) { continue; }
+        
+        if(!formation.IsAlive(slot)) {
+            //a shot before this one got there first
+            float bulletSize = projectiles.size[i];
+            slot = formation.HitTest(projectiles.x[i], projectiles.y[i], bulletSize, bulletSize);
+            if(slot == -1) { continue; }
+        }
+        formation.Kill(slot);
+        projectiles.Kill(i);
+    }
+    collisionZone.End();
+    timer.Lap(SUBSYSTEM_BULLETS);
+}
+
+static int countBits(uint32_t bits) {
+    bits = bits - ((bits >> 1) & 0x55555555u);
+    bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+    return (int)((((bits + (bits >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+}
+
+struct EnemySprites {
+    const Formation *formation;
+    const int *offsets;
+    RenderSnapshot *snapshot;
+};
+
+// sprite stage over a range of formation words; each word's sprites start at its offset
+static void writeEnemySprites(void *data, int begin, int end) {
+    EnemySprites &enemies = *(EnemySprites*)data;
+    const Formation &formation = *enemies.formation;
+    const std::vector<uint32_t> &alive = formation.AliveBits();
+    float enemySize = formation.SlotSize();
+    for(int word = begin; word < end; word++) {
+        SnapshotSprite *sprite = &enemies.snapshot->sprites[enemies.offsets[word]];
+        uint32_t bits = alive[word];
+        for(int bit = 0; bits; bit++, bits >>= 1) {
+            if(!(bits & 1)) { continue; }
+            formation.SlotPosition(word * 32 + bit, sprite->x, sprite->y);
+            sprite->size = enemySize;
+            sprite->kind = SPRITE_ENEMY;
+            sprite++;
+        }
+    }
+}
+
+void GameState::WriteSnapshot(RenderSnapshot &snapshot) const {
+    
+    snapshot.mode = mode;
+    snapshot.enemiesLeft = formation.AliveCount();
+    if(mode != STATE_GAME_LEVEL) {
+        snapshot.sprites.clear();
+        return;
+    }
+    
+    //live slots only, skipping empty words whole; counting first lets every
+    //word write its own sprites
+    const std::vector<uint32_t> &alive = formation.AliveBits();
+    int words = (int)alive.size();
+    snapshotOffsets.resize(words + 1);
+    snapshotOffsets[0] = 0;
+    for(int word = 0; word < words; word++) {
+        snapshotOffsets[word + 1] = snapshotOffsets[word] + countBits(alive[word]);
+    }
+    int enemies = snapshotOffsets[words];
+    snapshot.sprites.resize(enemies + 1 + projectiles.Count());
+    EnemySprites job = { &formation, &snapshotOffsets[0], &snapshot };
+    jobs.ParallelFor(writeEnemySprites, &job, words, SNAPSHOT_GRAIN);
+    
+    //player coordinates are in units of its own size
+    SnapshotSprite ship = { player.xPos * PLAYER_SCALE, player.yPos * PLAYER_SCALE, PLAYER_SCALE, SPRITE_PLAYER };
+    snapshot.sprites[enemies] = ship;
+    
+    for(int i = 0; i < projectiles.Count(); i++) {
+        SnapshotSprite shot = { projectiles.x[i], projectiles.y[i], projectiles.size[i],
+                                projectiles.owner[i] == OWNER_PLAYER ? SPRITE_PLAYER_SHOT : SPRITE_ENEMY_SHOT };
+        snapshot.sprites[enemies + 1 + i] = shot;
+    }
+}
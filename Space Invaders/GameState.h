@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include "SimTimer.h"
+#include "Formation.h"
+#include "Random.h"
+#include "ProjectilePool.h"
+#include <stdint.h>
+
+// Update is one step of the simulation thread, which runs at this rate
+#define INVADERS_TICK (1.0f/60.0f)
+
+// player position is in grid units; this maps it to world (screen) space
+#define PLAYER_SCALE 0.2f
+
+// shots, world units and seconds
+#define BULLET_SIZE 0.03f
+#define BULLET_SPEED 1.8f
+#define BULLET_LIFETIME 2.0f
+#define ENEMY_SHOT_SIZE 0.04f
+#define ENEMY_SHOT_SPEED 1.32f
+#define ENEMY_SHOT_LIFETIME 3.0f
+#define ENEMY_FIRE_INTERVAL 30
+
+// smallest range worth handing to another thread: shots for movement and
+// hit tests, 32-slot words of the formation for snapshot sprites
+#define SHOT_GRAIN 256
+#define SNAPSHOT_GRAIN 64
+
+enum GameMode { STATE_MAIN_MENU, STATE_GAME_LEVEL};
+
+// one random stream per system, so adding draws in one never shifts another
+enum RandomStream { RANDOM_ENEMY_FIRE, RANDOM_STREAM_COUNT };
+
+// subsystems timed by the headless benchmark
+enum SimSubsystem { SUBSYSTEM_FORMATION, SUBSYSTEM_ENEMY_FIRE, SUBSYSTEM_PLAYER, SUBSYSTEM_BULLETS, SUBSYSTEM_SNAPSHOT, SUBSYSTEM_COUNT };
+extern const char *simSubsystemNames[SUBSYSTEM_COUNT];
+
+bool checkCollision(float x1, float y1, float w1, float h1, float x2, float y2, float w2, float h2);
+
+// input for one tick; fire is a press during the tick, the rest is key state
+struct InvadersInput {
+    bool left;
+    bool right;
+    bool start;
+    bool fire;
+};
+
+// what a snapshot sprite is drawn as
+enum SnapshotSpriteKind { SPRITE_ENEMY, SPRITE_PLAYER, SPRITE_PLAYER_SHOT, SPRITE_ENEMY_SHOT };
+
+// world space center and size; every sprite in the game is square
+struct SnapshotSprite {
+    float x;
+    float y;
+    float size;
+    SnapshotSpriteKind kind;
+};
+
+// Everything the renderer needs from one Update, copied out so drawing never
+// reads the GameState the simulation thread is changing.
+struct RenderSnapshot {
+    GameMode mode;
+    // live invaders, the player, then shots
+    std::vector<SnapshotSprite> sprites;
+    int enemiesLeft;
+    // when the step was due, SimulationThread::Now time
+    uint64_t time;
+};
+
+class Entity {
+public:
+    
+    Entity();
+    
+    int xPos;
+    int yPos;
+    
+    float health;
+    float rotation;
+    
+    bool collision = false;
+};
+
+// Everything Space Invaders simulates, kept apart from SDL and GL so it can
+// run without a window. One Update is one frame of the original game loop,
+// INVADERS_TICK long.
+class GameState {
+public:
+    
+    GameState();
+    void Update(const InvadersInput &input);
+    
+    // replaces the built-in wave with the ones in the file, if it has any
+    bool LoadWaves(const char *fileName);
+    void StartWave(int index);
+    
+    // reseeds every random stream; the same seed and input replay the same game
+    void Seed(uint64_t seed);
+    
+    // copies what the renderer draws; reuses the snapshot's storage.
+    // Invader sprites are written in parallel
+    void WriteSnapshot(RenderSnapshot &snapshot) const;
+    
+    GameMode mode;
+    
+    Entity player;
+    
+    // the current wave; the next one starts when it is cleared
+    Formation formation;
+    std::vector<WaveLayout> waves;
+    int waveIndex;
+    
+    // player and enemy shots
+    ProjectilePool projectiles;
+    int enemyFireCooldown;
+    
+    // formation slot each shot hit this step, or -1; worked out in parallel
+    std::vector<int> shotHits;
+    // first sprite of each formation word, for WriteSnapshot
+    mutable std::vector<int> snapshotOffsets;
+    
+    uint64_t seed;
+    Random random[RANDOM_STREAM_COUNT];
+    
+    SimTimer timer;
+};
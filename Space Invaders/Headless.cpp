@@ -0,0 +1,82 @@
+#include "Headless.h"
+#include "GameState.h"
+#include "Profiler.h"
+#include "Logger.h"
+#include "JobSystem.h"
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+// deterministic input: start the game, sweep the player from side to side
+// and fire on a steady rhythm
+static void ScriptInput(int tick, InvadersInput &input) {
+    input.start = tick == 0;
+    input.left = (tick / 16) % 2 == 0;
+    input.right = !input.left;
+    input.fire = tick % 5 == 0;
+}
+
+// FNV-1a over the last snapshot's sprites, so runs with different worker
+// counts can be checked for the exact same result
+static uint32_t HashSprites(const RenderSnapshot &snapshot) {
+    uint32_t hash = 2166136261u;
+    for(int i = 0; i < (int)snapshot.sprites.size(); i++) {
+        const SnapshotSprite &sprite = snapshot.sprites[i];
+        float position[3] = { sprite.x, sprite.y, sprite.size };
+        const unsigned char *bytes = (const unsigned char*)position;
+        for(int b = 0; b < (int)sizeof(position); b++) {
+            hash = (hash ^ bytes[b]) * 16777619u;
+        }
+        hash = (hash ^ (uint32_t)sprite.kind) * 16777619u;
+    }
+    return hash;
+}
+
+int RunHeadless(int ticks, const char *wavesFile, int workers) {
+
+    GameState state;
+    state.timer.enabled = true;
+    if(wavesFile && !state.LoadWaves(wavesFile)) {
+        return 1;
+    }
+
+    InvadersInput input = { false, false, false, false };
+    //the snapshot is written every step, as on the simulation thread
+    RenderSnapshot snapshot;
+    jobs.Start(workers);
+
+    //log lines from the run are drained in the background, like in the game
+    logStart();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int tick = 0; tick < ticks; tick++) {
+        ScriptInput(tick, input);
+        state.Update(input);
+        state.WriteSnapshot(snapshot);
+        state.timer.Lap(SUBSYSTEM_SNAPSHOT);
+        profiler.EndFrame();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    logShutdown();
+    jobs.Stop();
+
+    printf("\nheadless: seed %llu, %d ticks with %d job workers in %.4f s (%.0f ticks/s)\n", (unsigned long long)state.seed, ticks, workers, seconds, ticks / seconds);
+    for(int i = 0; i < SUBSYSTEM_COUNT; i++) {
+        printf("  %-10s %9.3f ms %9.3f us/tick\n", simSubsystemNames[i], state.timer.seconds[i] * 1000.0, state.timer.seconds[i] * 1000000.0 / ticks);
+    }
+    printf("  wave %d, %d of %d enemies alive, %d shots in flight, player at %d\n", state.waveIndex + 1, state.formation.AliveCount(), state.formation.SlotCount(), state.projectiles.Count(), state.player.xPos);
+    printf("  %d sprites in the last snapshot, hash %08x\n", (int)snapshot.sprites.size(), HashSprites(snapshot));
+
+    //zones inside the simulation, one frame per tick
+    profiler.Report();
+
+    return 0;
+}
+
+#ifdef HEADLESS_MAIN
+// build without SDL or GL for GPU-less boxes:
+// c++ -DHEADLESS_MAIN Headless.cpp GameState.cpp JobSystem.cpp Profiler.cpp Logger.cpp SpatialGrid.cpp ProjectilePool.cpp Formation.cpp Random.cpp
+int main(int argc, char *argv[]) {
+    return RunHeadless(argc > 1 ? atoi(argv[1]) : 100000, argc > 2 ? argv[2] : NULL, argc > 3 ? atoi(argv[3]) : 0);
+}
+#endif
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+// Runs the simulation for the given number of ticks with scripted input and
+// no window or GL context, then prints simulation ticks per second and the
+// time spent in each subsystem. wavesFile, if given, replaces the built-in
+// wave; workers sets how many job system threads help the one running the
+// loop. Returns the process exit code.
+int RunHeadless(int ticks, const char *wavesFile = NULL, int workers = 0);
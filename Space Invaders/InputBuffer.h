@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <deque>
+#include <mutex>
+
+// actions a game can bind keys to, and scancodes that can be bound (SDL's
+// SDL_NUM_SCANCODES)
+#define INPUT_MAX_ACTIONS 8
+#define INPUT_MAX_SCANCODES 512
+#define INPUT_UNBOUND -1
+
+// how long presses waited between the key event and the start of the step
+// that applied them
+struct InputStats {
+    uint64_t presses;
+    uint64_t totalLatencyNanoseconds;
+    uint64_t worstLatencyNanoseconds;
+};
+
+// Key transitions from the main thread, stamped with the time the key
+// actually moved and handed to the simulation tick they fall in. The main
+// thread binds scancodes to actions and passes every key event in; each
+// step calls Advance with the time it was due and then asks about the
+// actions for that tick.
+//
+// Because transitions are queued rather than sampled once a frame, a key
+// pressed and released between two steps still shows up as a press, and a
+// press lands on the step it happened before even if the frame that saw it
+// came later.
+class InputBuffer {
+    public:
+
+        InputBuffer();
+
+        // main thread
+        void Bind(int scancode, int action);
+        // eventMilliseconds is the SDL event's timestamp and nowMilliseconds
+        // SDL_GetTicks, which run on the same clock; the transition is moved
+        // onto SimulationThread::Now's. Key repeats are ignored.
+        void KeyEvent(int scancode, bool down, uint32_t eventMilliseconds, uint32_t nowMilliseconds);
+        // time is clamped to at least the last transition's, so the queue
+        // stays in order
+        void Record(int action, bool down, uint64_t time);
+
+        // simulation thread; applies every transition stamped at or before
+        // time
+        void Advance(uint64_t time);
+
+        // down when the tick ended
+        bool Held(int action) const { return held[action]; }
+        // down at any point during the tick, so a tap shorter than a step
+        // still moves things for one
+        bool Down(int action) const { return wasHeld[action] || pressed[action] > 0; }
+        int Pressed(int action) const { return pressed[action]; }
+        int Released(int action) const { return released[action]; }
+
+        // any thread
+        InputStats Stats() const;
+
+    private:
+
+        struct InputEvent {
+            uint64_t time;
+            int action;
+            bool down;
+        };
+
+        int bindings[INPUT_MAX_SCANCODES];
+        // main thread only; drops transitions that change nothing
+        bool recordedDown[INPUT_MAX_ACTIONS];
+        // main thread only; stamps are kept from going backwards
+        uint64_t lastRecorded;
+
+        // guards queue and stats
+        mutable std::mutex mutex;
+        std::deque<InputEvent> queue;
+        InputStats stats;
+
+        // simulation thread only
+        bool held[INPUT_MAX_ACTIONS];
+        bool wasHeld[INPUT_MAX_ACTIONS];
+        int pressed[INPUT_MAX_ACTIONS];
+        int released[INPUT_MAX_ACTIONS];
+};
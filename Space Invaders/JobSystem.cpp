@@ -0,0 +1,151 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+JobSystem jobs;
+
+// queue the current thread pushes to and pops from first
+static thread_local int threadQueue = 0;
+
+JobSystem::JobSystem() : queued(0), stopping(false) {
+    queues.push_back(new JobQueue());
+}
+
+JobSystem::~JobSystem() {
+    Stop();
+    for(int i = 0; i < (int)queues.size(); i++) {
+        delete queues[i];
+    }
+}
+
+void JobSystem::Start(int workers) {
+    if(!threads.empty()) { return; }
+    if(workers < 0) {
+        workers = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+    }
+
+    stopping = false;
+    //queues are only added while nothing is running, so readers never see them move
+    while((int)queues.size() < workers + 1) {
+        queues.push_back(new JobQueue());
+    }
+    for(int i = 0; i < workers; i++) {
+        threads.push_back(std::thread(&JobSystem::WorkerLoop, this, i + 1));
+    }
+}
+
+void JobSystem::Stop() {
+    if(threads.empty()) { return; }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(int i = 0; i < (int)threads.size(); i++) {
+        threads[i].join();
+    }
+    threads.clear();
+}
+
+void JobSystem::Dispatch(JobFunction function, void *data, int count, int grain, JobCounter &counter) {
+    if(count <= 0) { return; }
+    grain = std::max(1, grain);
+
+    //enough ranges to keep every thread busy, none smaller than grain
+    int ranges = std::min((count + grain - 1) / grain, (WorkerCount() + 1) * JOB_RANGES_PER_THREAD);
+    int rangeSize = (count + ranges - 1) / ranges;
+    rangeSize = (rangeSize + grain - 1) / grain * grain;
+    ranges = (count + rangeSize - 1) / rangeSize;
+
+    counter.pending.fetch_add(ranges, std::memory_order_relaxed);
+    JobQueue &queue = *queues[threadQueue];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        //pushed back to front so the owner, popping from the back, starts at
+        //the beginning while thieves take the far end
+        for(int i = ranges - 1; i >= 0; i--) {
+            Job job = { function, data, i * rangeSize, std::min(count, (i + 1) * rangeSize), &counter };
+            queue.jobs.push_back(job);
+        }
+    }
+    queued.fetch_add(ranges, std::memory_order_release);
+
+    if(!threads.empty()) {
+        //taking the lock orders this against a worker about to sleep
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_all();
+    }
+}
+
+void JobSystem::Wait(JobCounter &counter) {
+    Job job;
+    while(!counter.Done()) {
+        if(TakeJob(threadQueue, job)) {
+            Execute(job);
+        } else {
+            //the last ranges are running elsewhere
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(JobFunction function, void *data, int count, int grain) {
+    //one range, or nobody to share it with: skip the queues
+    if(count <= grain || threads.empty()) {
+        if(count > 0) { function(data, 0, count); }
+        return;
+    }
+    JobCounter counter;
+    Dispatch(function, data, count, grain, counter);
+    Wait(counter);
+}
+
+bool JobSystem::TakeJob(int queue, Job &job) {
+    if(queued.load(std::memory_order_acquire) == 0) { return false; }
+
+    //own queue first, newest job
+    {
+        JobQueue &own = *queues[queue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if(!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    //then steal the oldest job from the others, starting with the next queue
+    int queueCount = (int)queues.size();
+    for(int i = 1; i < queueCount; i++) {
+        JobQueue &other = *queues[(queue + i) % queueCount];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if(!other.jobs.empty()) {
+            job = other.jobs.front();
+            other.jobs.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::Execute(const Job &job) {
+    job.function(job.data, job.begin, job.end);
+    job.counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::WorkerLoop(int queue) {
+    threadQueue = queue;
+    Job job;
+    while(true) {
+        if(TakeJob(queue, job)) {
+            Execute(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if(stopping) { break; }
+        if(queued.load(std::memory_order_acquire) == 0) {
+            wake.wait(lock);
+        }
+    }
+}
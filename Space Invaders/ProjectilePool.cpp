@@ -0,0 +1,66 @@
+#include "ProjectilePool.h"
+
+ProjectilePool::ProjectilePool(int capacity) : count(0) {
+    //allocated once up front; firing never allocates
+    x.resize(capacity);
+    y.resize(capacity);
+    velocityX.resize(capacity);
+    velocityY.resize(capacity);
+    size.resize(capacity);
+    life.resize(capacity);
+    owner.resize(capacity);
+}
+
+bool ProjectilePool::Fire(ProjectileOwner newOwner, float newX, float newY, float newVelocityX, float newVelocityY, float newSize, float lifetime) {
+    if(count == Capacity()) { return false; }
+
+    x[count] = newX;
+    y[count] = newY;
+    velocityX[count] = newVelocityX;
+    velocityY[count] = newVelocityY;
+    size[count] = newSize;
+    life[count] = lifetime;
+    owner[count] = (unsigned char)newOwner;
+    count++;
+    return true;
+}
+
+void ProjectilePool::Kill(int index) {
+    count--;
+    if(index == count) { return; }
+
+    x[index] = x[count];
+    y[index] = y[count];
+    velocityX[index] = velocityX[count];
+    velocityY[index] = velocityY[count];
+    size[index] = size[count];
+    life[index] = life[count];
+    owner[index] = owner[count];
+}
+
+void ProjectilePool::Clear() {
+    count = 0;
+}
+
+void ProjectilePool::Update(float elapsed, float minX, float minY, float maxX, float maxY) {
+    Move(elapsed, 0, count);
+    Cull(minX, minY, maxX, maxY);
+}
+
+void ProjectilePool::Move(float elapsed, int begin, int end) {
+    for(int i = begin; i < end; i++) {
+        x[i] += velocityX[i] * elapsed;
+        y[i] += velocityY[i] * elapsed;
+        life[i] -= elapsed;
+    }
+}
+
+void ProjectilePool::Cull(float minX, float minY, float maxX, float maxY) {
+    //walk backwards so the shot swapped into a freed slot has already been checked
+    for(int i = count - 1; i >= 0; i--) {
+        float half = size[i] / 2;
+        if(life[i] <= 0.0f || x[i] + half < minX || x[i] - half > maxX || y[i] + half < minY || y[i] - half > maxY) {
+            Kill(i);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#define MAX_PROJECTILES 4096
+
+enum ProjectileOwner { OWNER_PLAYER, OWNER_ENEMY };
+
+// Fixed capacity pool of shots from both sides, stored as parallel arrays.
+// Live projectiles are packed into [0, Count()); killing one moves the last
+// live projectile into its place, so firing and recycling are O(1) and every
+// pass over the pool only touches live shots. Positions and velocities are in
+// world space, lifetimes in seconds.
+class ProjectilePool {
+    public:
+
+        ProjectilePool(int capacity = MAX_PROJECTILES);
+
+        // false when the pool is full; the shot is dropped
+        bool Fire(ProjectileOwner owner, float x, float y, float velocityX, float velocityY, float size, float lifetime);
+        void Kill(int index);
+        void Clear();
+
+        // moves every shot and recycles the ones that expired or left the box
+        void Update(float elapsed, float minX, float minY, float maxX, float maxY);
+        // the two halves of Update; Move only touches shots [begin, end), so
+        // ranges can move on different threads, Cull reorders the pool
+        void Move(float elapsed, int begin, int end);
+        void Cull(float minX, float minY, float maxX, float maxY);
+
+        int Count() const { return count; }
+        int Capacity() const { return (int)x.size(); }
+
+        // live projectiles are [0, Count())
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> velocityX;
+        std::vector<float> velocityY;
+        std::vector<float> size;
+        std::vector<float> life;
+        std::vector<unsigned char> owner;
+
+    private:
+
+        int count;
+};
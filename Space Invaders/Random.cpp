@@ -0,0 +1,59 @@
+#include "Random.h"
+
+static inline uint32_t rotateLeft(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// splitmix64, only used to spread a seed over the whole state
+static uint64_t splitMix(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+Random::Random(uint64_t seed, uint32_t stream) {
+    Seed(seed, stream);
+}
+
+void Random::Seed(uint64_t seed, uint32_t stream) {
+    //the stream goes through the mixer too, so neighbouring streams share nothing
+    uint64_t x = seed ^ ((uint64_t)stream * 0xD1B54A32D192ED03ull);
+    uint64_t a = splitMix(x);
+    uint64_t b = splitMix(x);
+    state.s[0] = (uint32_t)a;
+    state.s[1] = (uint32_t)(a >> 32);
+    state.s[2] = (uint32_t)b;
+    state.s[3] = (uint32_t)(b >> 32);
+    //all zero is the one state xoshiro never leaves
+    if(!(state.s[0] | state.s[1] | state.s[2] | state.s[3])) {
+        state.s[0] = 1;
+    }
+}
+
+uint32_t Random::Next() {
+    uint32_t *s = state.s;
+    uint32_t result = rotateLeft(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotateLeft(s[3], 11);
+    return result;
+}
+
+int Random::Range(int count) {
+    //multiply and keep the high word instead of %, no division
+    return (int)(((uint64_t)Next() * (uint32_t)count) >> 32);
+}
+
+float Random::Float() {
+    //top 24 bits fill a float mantissa exactly
+    return (Next() >> 8) * (1.0f / 16777216.0f);
+}
+
+float Random::Range(float min, float max) {
+    return min + (max - min) * Float();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+
+// everything a generator needs to carry on exactly where it left off
+struct RandomState {
+    uint32_t s[4];
+};
+
+// xoshiro128** generator. Seed it once; a different stream number with the
+// same seed gives an unrelated sequence, so each system can draw from its own
+// stream without disturbing the others. Save() and Restore() capture and
+// replay a generator for reproducible runs.
+class Random {
+    public:
+
+        Random(uint64_t seed = 1, uint32_t stream = 0);
+
+        void Seed(uint64_t seed, uint32_t stream = 0);
+
+        uint32_t Next();
+
+        // uniform in [0, count); count must be positive
+        int Range(int count);
+        // uniform in [0, 1)
+        float Float();
+        float Range(float min, float max);
+
+        RandomState Save() const { return state; }
+        void Restore(const RandomState &saved) { state = saved; }
+
+    private:
+
+        RandomState state;
+};
@@ -0,0 +1,39 @@
+#include "Simulation.h"
+#include "Profiler.h"
+
+Simulation::Simulation(GameState &gameState) : state(gameState) {
+
+}
+
+Simulation::~Simulation() {
+    Stop();
+}
+
+void Simulation::Begin(double stepSeconds, int maxSteps) {
+    //so the renderer has something to draw before the first step lands
+    RenderSnapshot &snapshot = snapshots.WriteSlot();
+    state.WriteSnapshot(snapshot);
+    snapshot.time = Now();
+    snapshots.Publish();
+    Start(stepSeconds, maxSteps);
+}
+
+void Simulation::Step(uint64_t time) {
+    //one shot per press, taken by the step the press came before
+    inputs.Advance(time);
+    InvadersInput input;
+    input.left = inputs.Down(ACTION_LEFT);
+    input.right = inputs.Down(ACTION_RIGHT);
+    input.start = inputs.Down(ACTION_START);
+    input.fire = inputs.Pressed(ACTION_FIRE) > 0;
+
+    {
+        PROFILE_ZONE("update");
+        state.Update(input);
+    }
+
+    RenderSnapshot &snapshot = snapshots.WriteSlot();
+    state.WriteSnapshot(snapshot);
+    snapshot.time = time;
+    snapshots.Publish();
+}
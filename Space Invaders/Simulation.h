@@ -0,0 +1,35 @@
+#pragma once
+
+#include "GameState.h"
+#include "InputBuffer.h"
+#include "SimulationThread.h"
+#include "SnapshotBuffer.h"
+
+// what the keys are bound to
+enum InvadersAction { ACTION_LEFT, ACTION_RIGHT, ACTION_START, ACTION_FIRE };
+
+// Runs Space Invaders' GameState on its own thread, one Update every
+// INVADERS_TICK. The main thread passes key events to inputs and draws the
+// newest snapshot; the GameState itself belongs to the simulation thread
+// until Stop returns.
+class Simulation : public SimulationThread {
+    public:
+
+        Simulation(GameState &gameState);
+        ~Simulation();
+
+        // publishes a snapshot of the current state, then starts stepping;
+        // stepSeconds 0 runs flat out (see SimulationThread::Start)
+        void Begin(double stepSeconds = INVADERS_TICK, int maxSteps = 0);
+
+        InputBuffer inputs;
+        SnapshotBuffer<RenderSnapshot> snapshots;
+
+    protected:
+
+        void Step(uint64_t time);
+
+    private:
+
+        GameState &state;
+};
@@ -0,0 +1,134 @@
+#include "SpatialGrid.h"
+#include <cmath>
+#include <algorithm>
+
+SpatialGrid::SpatialGrid() : cellCountX(0), cellCountY(0), originX(0.0f), originY(0.0f), cellSize(1.0f), queryStamp(0) {
+
+}
+
+void SpatialGrid::Setup(float minX, float minY, float maxX, float maxY, float newCellSize) {
+    originX = minX;
+    originY = minY;
+    cellSize = newCellSize;
+    cellCountX = std::max(1, (int)ceilf((maxX - minX) / cellSize));
+    cellCountY = std::max(1, (int)ceilf((maxY - minY) / cellSize));
+
+    cells.assign(cellCountX * cellCountY, std::vector<int>());
+    int count = (int)ranges.size();
+    ranges.clear();
+    present.clear();
+    stamps.clear();
+    Resize(count);
+}
+
+void SpatialGrid::Resize(int count) {
+    for(int i = count; i < (int)present.size(); i++) {
+        Remove(i);
+    }
+    CellRange empty = { 0, 0, -1, -1 };
+    ranges.resize(count, empty);
+    present.resize(count, false);
+    stamps.resize(count, 0);
+}
+
+void SpatialGrid::Clear() {
+    for(int i = 0; i < (int)cells.size(); i++) {
+        cells[i].clear();
+    }
+    for(int i = 0; i < (int)present.size(); i++) {
+        present[i] = false;
+    }
+}
+
+SpatialGrid::CellRange SpatialGrid::RangeFor(float x, float y, float width, float height) const {
+    CellRange range;
+    range.minX = (int)floorf((x - width/2 - originX) / cellSize);
+    range.minY = (int)floorf((y - height/2 - originY) / cellSize);
+    range.maxX = (int)floorf((x + width/2 - originX) / cellSize);
+    range.maxY = (int)floorf((y + height/2 - originY) / cellSize);
+
+    range.minX = std::min(std::max(range.minX, 0), cellCountX - 1);
+    range.minY = std::min(std::max(range.minY, 0), cellCountY - 1);
+    range.maxX = std::min(std::max(range.maxX, 0), cellCountX - 1);
+    range.maxY = std::min(std::max(range.maxY, 0), cellCountY - 1);
+    return range;
+}
+
+void SpatialGrid::Insert(int item, const CellRange &range) {
+    for(int cellY = range.minY; cellY <= range.maxY; cellY++) {
+        for(int cellX = range.minX; cellX <= range.maxX; cellX++) {
+            cells[cellY * cellCountX + cellX].push_back(item);
+        }
+    }
+}
+
+void SpatialGrid::Erase(int item, const CellRange &range) {
+    for(int cellY = range.minY; cellY <= range.maxY; cellY++) {
+        for(int cellX = range.minX; cellX <= range.maxX; cellX++) {
+            std::vector<int> &cell = cells[cellY * cellCountX + cellX];
+            //order inside a cell does not matter; swap with the back
+            for(int i = 0; i < (int)cell.size(); i++) {
+                if(cell[i] == item) {
+                    cell[i] = cell.back();
+                    cell.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::Update(int item, float x, float y, float width, float height) {
+    CellRange range = RangeFor(x, y, width, height);
+    if(present[item]) {
+        const CellRange &old = ranges[item];
+        if(old.minX == range.minX && old.minY == range.minY && old.maxX == range.maxX && old.maxY == range.maxY) {
+            return;
+        }
+        Erase(item, old);
+    }
+    Insert(item, range);
+    ranges[item] = range;
+    present[item] = true;
+}
+
+void SpatialGrid::Remove(int item) {
+    if(!present[item]) { return; }
+    Erase(item, ranges[item]);
+    present[item] = false;
+}
+
+void SpatialGrid::Query(float x, float y, float width, float height, std::vector<int> &candidates) {
+
+    queryStamp++;
+    if(queryStamp == 0) {
+        //wrapped; old stamps could collide with new ones
+        std::fill(stamps.begin(), stamps.end(), 0);
+        queryStamp = 1;
+    }
+
+    CellRange range = RangeFor(x, y, width, height);
+    for(int cellY = range.minY; cellY <= range.maxY; cellY++) {
+        for(int cellX = range.minX; cellX <= range.maxX; cellX++) {
+            const std::vector<int> &cell = cells[cellY * cellCountX + cellX];
+            for(int i = 0; i < (int)cell.size(); i++) {
+                int item = cell[i];
+                if(stamps[item] != queryStamp) {
+                    stamps[item] = queryStamp;
+                    candidates.push_back(item);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::QueryShared(float x, float y, float width, float height, std::vector<int> &candidates) const {
+
+    CellRange range = RangeFor(x, y, width, height);
+    for(int cellY = range.minY; cellY <= range.maxY; cellY++) {
+        for(int cellX = range.minX; cellX <= range.maxX; cellX++) {
+            const std::vector<int> &cell = cells[cellY * cellCountX + cellX];
+            candidates.insert(candidates.end(), cell.begin(), cell.end());
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+// Uniform grid broadphase over a fixed rectangle of the world. Items are
+// boxes given by center and size; each one is listed in every cell its box
+// touches. Update only touches the cell lists when the box moves into a
+// different set of cells, so slow or still items cost a compare per tick.
+// Boxes past the edges are clamped into the border cells, so nothing is
+// ever missed, only tested more often.
+class SpatialGrid {
+    public:
+
+        SpatialGrid();
+
+        void Setup(float minX, float minY, float maxX, float maxY, float cellSize);
+
+        // item ids are 0..count-1; growing keeps existing items
+        void Resize(int count);
+        void Clear();
+
+        void Update(int item, float x, float y, float width, float height);
+        void Remove(int item);
+
+        // appends every item whose cells overlap the box, each once
+        void Query(float x, float y, float width, float height, std::vector<int> &candidates);
+        // the same, safe to run from several threads at once; an item in more
+        // than one of the cells is listed again for each, after its first time
+        void QueryShared(float x, float y, float width, float height, std::vector<int> &candidates) const;
+
+        int cellCountX;
+        int cellCountY;
+
+    private:
+
+        struct CellRange {
+            int minX;
+            int minY;
+            int maxX;
+            int maxY;
+        };
+
+        CellRange RangeFor(float x, float y, float width, float height) const;
+        void Insert(int item, const CellRange &range);
+        void Erase(int item, const CellRange &range);
+
+        float originX;
+        float originY;
+        float cellSize;
+
+        std::vector<std::vector<int> > cells;
+        std::vector<CellRange> ranges;
+        std::vector<bool> present;
+
+        // last query each item was returned by, to skip duplicates
+        std::vector<unsigned int> stamps;
+        unsigned int queryStamp;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+#include <vector>
+
+#include "ShaderProgram.h"
+#include "SpriteBatch.h"
+
+// x, y, width, height | u, v, uv width, uv height | r, g, b, a
+#define SPRITE_INSTANCE_FLOATS 12
+
+// where the instanced program (vertex_instanced.glsl) takes its per-sprite
+// data; look them up with glGetAttribLocation after loading it
+struct InstanceAttributes {
+    GLint placement;
+    GLint uvRect;
+    GLint tint;
+};
+
+// Draws axis-aligned textured sprites as instances of one static unit quad:
+// each sprite is SPRITE_INSTANCE_FLOATS floats in a buffer uploaded once per
+// flush, and each run of sprites sharing a texture is one instanced draw.
+// Nothing is transformed on the CPU, so this is the path for large sprite
+// counts.
+//
+// When the device cannot instance, or the instanced program did not load,
+// sprites go to a SpriteBatch with the plain textured program instead. That
+// path has no per-vertex color, so tints are dropped there.
+//
+// Flush sorts by layer, then texture, keeping submission order within a key;
+// submitting in that order already skips the sort.
+class SpriteInstancer {
+    public:
+
+        SpriteInstancer();
+
+        // instancedProgram may be NULL to always batch; call again after
+        // changing devices
+        void Setup(ShaderProgram *instancedProgram, const InstanceAttributes &attributes, ShaderProgram *fallbackProgram);
+        bool Instancing() const { return instancing; }
+
+        // view and projection for whichever program ends up drawing
+        void SetMatrices(const glm::mat4 &projectionMatrix, const glm::mat4 &viewMatrix);
+
+        // tint for the sprites drawn after this, white to begin with
+        void SetTint(float r, float g, float b, float a);
+
+        // x, y is the center; uv rect is the top left corner of the region and its size
+        void Draw(GLuint texture, float x, float y, float width, float height,
+                  float u, float v, float uvWidth, float uvHeight, int layer = 0);
+
+        // one cell of a uniform sprite sheet, counted left to right, top to bottom
+        void DrawSheetSprite(GLuint texture, float x, float y, float width, float height,
+                             int index, int spriteCountX, int spriteCountY, int layer = 0);
+
+        // draws everything collected so far and leaves the instancer empty
+        void Flush();
+
+        void Cleanup();
+
+        int drawCallsLastFlush;
+        int spritesLastFlush;
+
+    private:
+
+        struct InstanceKey {
+            int layer;
+            GLuint texture;
+        };
+
+        struct KeyOrder {
+            const std::vector<InstanceKey> *keys;
+            bool operator()(int a, int b) const;
+        };
+
+        bool instancing;
+        ShaderProgram *program;
+        InstanceAttributes attributes;
+        ShaderProgram *fallbackProgram;
+        SpriteBatch fallback;
+
+        float tint[4];
+
+        std::vector<InstanceKey> keys;
+        std::vector<float> instances;
+        // false once a sprite was drawn with a key ordered before the last one
+        bool inOrder;
+
+        std::vector<int> sorted;
+        std::vector<InstanceKey> sortedKeys;
+        std::vector<float> sortedInstances;
+
+        GLuint quadBuffer;
+        GLuint instanceBuffer;
+};
@@ -0,0 +1,145 @@
+#include "TextCache.h"
+#include "RenderState.h"
+#include <cstring>
+
+#define FLOATS_PER_GLYPH 24
+
+static unsigned int HashText(const char *text, float size, float spacing) {
+    //FNV-1a over the characters and the layout parameters
+    unsigned int hash = 2166136261u;
+    for(const char *c = text; *c; c++) {
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+    }
+    unsigned int bits[2];
+    memcpy(&bits[0], &size, sizeof(float));
+    memcpy(&bits[1], &spacing, sizeof(float));
+    hash = (hash ^ bits[0]) * 16777619u;
+    hash = (hash ^ bits[1]) * 16777619u;
+    return hash;
+}
+
+TextCache::TextCache() : buildCount(0), fontVersion(0), glyphWidth(0.0f), glyphHeight(0.0f), drawCounter(0) {
+    TextureRegion none = { 0, 0.0f, 0.0f, 1.0f, 1.0f };
+    font = none;
+    memset(glyphU, 0, sizeof(glyphU));
+    memset(glyphV, 0, sizeof(glyphV));
+    scratch.resize(TEXT_DYNAMIC_MAX_CHARS * FLOATS_PER_GLYPH);
+    entries.reserve(TEXT_CACHE_MAX_ENTRIES);
+}
+
+void TextCache::SetFont(const TextureRegion &newFont) {
+
+    if(fontVersion != 0 && newFont.texture == font.texture && newFont.u == font.u && newFont.v == font.v &&
+       newFont.width == font.width && newFont.height == font.height) {
+        return;
+    }
+
+    font = newFont;
+    fontVersion++;
+    glyphWidth = font.width / 16.0f;
+    glyphHeight = font.height / 16.0f;
+    for(int i = 0; i < 256; i++) {
+        glyphU[i] = font.u + (float)(i % 16) * glyphWidth;
+        glyphV[i] = font.v + (float)(i / 16) * glyphHeight;
+    }
+}
+
+void TextCache::Cleanup() {
+    for(int i = 0; i < (int)entries.size(); i++) {
+        renderState.DeleteBuffers(1, &entries[i].vertexBuffer);
+    }
+    entries.clear();
+}
+
+int TextCache::BuildQuads(const char *text, int maxChars, float size, float spacing, float *out) const {
+    int count = 0;
+    for(; text[count] && count < maxChars; count++) {
+        int spriteIndex = (unsigned char)text[count];
+        float u = glyphU[spriteIndex];
+        float v = glyphV[spriteIndex];
+        float left = ((size+spacing) * count) + (-0.5f * size);
+        float right = ((size+spacing) * count) + (0.5f * size);
+        float top = 0.5f * size;
+        float bottom = -0.5f * size;
+
+        float quad[FLOATS_PER_GLYPH] = {
+            left, top, u, v,
+            left, bottom, u, v + glyphHeight,
+            right, top, u + glyphWidth, v,
+            right, bottom, u + glyphWidth, v + glyphHeight,
+            right, top, u + glyphWidth, v,
+            left, bottom, u, v + glyphHeight,
+        };
+        memcpy(out, quad, sizeof(quad));
+        out += FLOATS_PER_GLYPH;
+    }
+    return count;
+}
+
+void TextCache::Bind(ShaderProgram &program, const void *positions, const void *texCoords) {
+    renderState.BindTexture(font.texture);
+    renderState.UseProgram(program);
+    renderState.AttributePointer(program.positionAttribute, 4 * sizeof(float), positions);
+    renderState.AttributePointer(program.texCoordAttribute, 4 * sizeof(float), texCoords);
+    renderState.UseAttributes(program.positionAttribute, program.texCoordAttribute);
+}
+
+void TextCache::Draw(ShaderProgram &program, const char *text, float size, float spacing) {
+
+    drawCounter++;
+    unsigned int hash = HashText(text, size, spacing);
+
+    Entry *entry = NULL;
+    for(int i = 0; i < (int)entries.size(); i++) {
+        if(entries[i].hash == hash && entries[i].size == size && entries[i].spacing == spacing && entries[i].text == text) {
+            entry = &entries[i];
+            break;
+        }
+    }
+
+    if(entry == NULL) {
+        if((int)entries.size() < TEXT_CACHE_MAX_ENTRIES) {
+            Entry newEntry;
+            newEntry.vertexBuffer = renderState.CreateBuffer();
+            entries.push_back(newEntry);
+            entry = &entries.back();
+        } else {
+            //reuse the least recently drawn string's buffer
+            entry = &entries[0];
+            for(int i = 1; i < (int)entries.size(); i++) {
+                if(entries[i].lastUsed < entry->lastUsed) { entry = &entries[i]; }
+            }
+        }
+        entry->hash = hash;
+        entry->text = text;
+        entry->size = size;
+        entry->spacing = spacing;
+        entry->fontVersion = -1;
+    }
+    entry->lastUsed = drawCounter;
+
+    renderState.BindArrayBuffer(entry->vertexBuffer);
+    if(entry->fontVersion != fontVersion) {
+        int length = (int)entry->text.size();
+        if((int)scratch.size() < length * FLOATS_PER_GLYPH) {
+            scratch.resize(length * FLOATS_PER_GLYPH);
+        }
+        int glyphs = BuildQuads(entry->text.c_str(), length, size, spacing, &scratch[0]);
+        renderState.BufferData(glyphs * FLOATS_PER_GLYPH * sizeof(float), &scratch[0]);
+        entry->vertexCount = glyphs * 6;
+        entry->fontVersion = fontVersion;
+        buildCount++;
+    }
+
+    //with a buffer bound the pointers are offsets into it
+    Bind(program, (const void*)0, (const void*)(2 * sizeof(float)));
+    renderState.DrawArrays(0, entry->vertexCount);
+    renderState.BindArrayBuffer(0);
+}
+
+void TextCache::DrawDynamic(ShaderProgram &program, const char *text, float size, float spacing) {
+    int glyphs = BuildQuads(text, TEXT_DYNAMIC_MAX_CHARS, size, spacing, &scratch[0]);
+    renderState.BindArrayBuffer(0);
+    Bind(program, &scratch[0], &scratch[2]);
+    renderState.DrawArrays(0, glyphs * 6);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+#include <vector>
+#include <string>
+
+#include "ShaderProgram.h"
+#include "TextureLoader.h"
+
+// strings kept as prebuilt vertex buffers; the least recently drawn one is
+// rebuilt in place once this many are cached
+#define TEXT_CACHE_MAX_ENTRIES 32
+
+// longest string DrawDynamic handles; longer ones are cut off
+#define TEXT_DYNAMIC_MAX_CHARS 128
+
+// Text from a 16x16 glyph sheet. Static strings (titles, prompts) are meshed
+// once per text/size/spacing into a vertex buffer and redrawn from it; strings
+// that change every frame (scores, counters) are written into one
+// preallocated array. Glyph UVs are worked out once per font. Neither path
+// allocates once the cache is warm.
+class TextCache {
+    public:
+
+        TextCache();
+
+        // GL thread; call whenever the font region may have moved (e.g. once
+        // the atlas has it), cached strings are rebuilt on their next draw
+        void SetFont(const TextureRegion &font);
+        void Cleanup();
+
+        // text laid out left to right from the model matrix origin, one glyph
+        // per size + spacing
+        void Draw(ShaderProgram &program, const char *text, float size, float spacing);
+        void DrawDynamic(ShaderProgram &program, const char *text, float size, float spacing);
+
+        // strings meshed so far; stops growing once the cache is warm
+        int buildCount;
+
+    private:
+
+        struct Entry {
+            unsigned int hash;
+            std::string text;
+            float size;
+            float spacing;
+            GLuint vertexBuffer;
+            int vertexCount;
+            int fontVersion;
+            unsigned int lastUsed;
+        };
+
+        // writes 6 vertices (x y u v) per glyph to out, returns the glyph count
+        int BuildQuads(const char *text, int maxChars, float size, float spacing, float *out) const;
+        void Bind(ShaderProgram &program, const void *positions, const void *texCoords);
+
+        TextureRegion font;
+        int fontVersion;
+        float glyphU[256];
+        float glyphV[256];
+        float glyphWidth;
+        float glyphHeight;
+
+        std::vector<Entry> entries;
+        std::vector<float> scratch;
+        unsigned int drawCounter;
+};
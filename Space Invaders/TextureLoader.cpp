@@ -0,0 +1,231 @@
+#include "TextureLoader.h"
+#include "RenderState.h"
+#include "stb_image.h"
+#include "Logger.h"
+#include <algorithm>
+
+TextureRegion TextureRegion::Cell(int index, int spriteCountX, int spriteCountY) const {
+    TextureRegion cell = *this;
+    cell.width = width / (float)spriteCountX;
+    cell.height = height / (float)spriteCountY;
+    cell.u = u + (float)(index % spriteCountX) * cell.width;
+    cell.v = v + (float)(index / spriteCountX) * cell.height;
+    return cell;
+}
+
+TextureLoader::TextureLoader() : pageSize(ATLAS_PAGE_SIZE), stopping(false) {
+    TextureRegion empty = { 0, 0.0f, 0.0f, 1.0f, 1.0f };
+    pendingRegion = empty;
+    failedRegion = empty;
+}
+
+TextureLoader::~TextureLoader() {
+    Shutdown();
+}
+
+void TextureLoader::Start(int threadCount) {
+
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    if(maxTextureSize > 0) {
+        pageSize = std::min(ATLAS_PAGE_SIZE, (int)maxTextureSize);
+    }
+
+    unsigned char transparent[4] = { 0, 0, 0, 0 };
+    unsigned char magenta[4] = { 255, 0, 255, 255 };
+    pendingRegion.texture = CreateTexture(1, 1, transparent);
+    failedRegion.texture = CreateTexture(1, 1, magenta);
+
+    if(threadCount <= 0) {
+        //leave a core for the game loop
+        threadCount = std::max(1, std::min(4, (int)std::thread::hardware_concurrency() - 1));
+    }
+    stopping = false;
+    for(int i = 0; i < threadCount; i++) {
+        workers.push_back(std::thread(&TextureLoader::WorkerLoop, this));
+    }
+}
+
+void TextureLoader::Shutdown() {
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(int i = 0; i < (int)workers.size(); i++) {
+        workers[i].join();
+    }
+    workers.clear();
+
+    //anything decoded but never uploaded
+    for(int i = 0; i < (int)decoded.size(); i++) {
+        stbi_image_free(decoded[i].pixels);
+    }
+    decoded.clear();
+    requested.clear();
+
+    std::vector<GLuint> textures;
+    for(int i = 0; i < (int)pages.size(); i++) {
+        textures.push_back(pages[i].texture);
+    }
+    for(int i = 0; i < (int)regions.size(); i++) {
+        if(statuses[i] == TEXTURE_READY && std::find(textures.begin(), textures.end(), regions[i].texture) == textures.end()) {
+            textures.push_back(regions[i].texture);
+        }
+    }
+    if(pendingRegion.texture) { textures.push_back(pendingRegion.texture); }
+    if(failedRegion.texture) { textures.push_back(failedRegion.texture); }
+    if(!textures.empty()) {
+        glDeleteTextures((GLsizei)textures.size(), &textures[0]);
+        renderState.Invalidate();
+    }
+
+    pages.clear();
+    regions.clear();
+    statuses.clear();
+    pendingRegion.texture = 0;
+    failedRegion.texture = 0;
+}
+
+int TextureLoader::Request(const char *filePath, bool allowAtlas) {
+
+    int id = (int)regions.size();
+    regions.push_back(pendingRegion);
+    statuses.push_back(TEXTURE_PENDING);
+
+    Job job;
+    job.id = id;
+    job.filePath = filePath;
+    job.allowAtlas = allowAtlas;
+    job.pixels = NULL;
+    job.width = 0;
+    job.height = 0;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        requested.push_back(job);
+    }
+    wake.notify_one();
+    return id;
+}
+
+void TextureLoader::WorkerLoop() {
+    while(true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            while(!stopping && requested.empty()) {
+                wake.wait(guard);
+            }
+            if(stopping) { return; }
+            job = requested.front();
+            requested.pop_front();
+        }
+
+        int comp;
+        job.pixels = stbi_load(job.filePath.c_str(), &job.width, &job.height, &comp, STBI_rgb_alpha);
+
+        std::lock_guard<std::mutex> guard(lock);
+        decoded.push_back(job);
+    }
+}
+
+void TextureLoader::Pump(int maxUploads) {
+    for(int i = 0; i < maxUploads; i++) {
+        Job job;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if(decoded.empty()) { return; }
+            job = decoded.front();
+            decoded.pop_front();
+        }
+        Upload(job);
+    }
+}
+
+void TextureLoader::Upload(Job &job) {
+
+    if(job.pixels == NULL) {
+        LOG_ERROR("Unable to load image %s. Make sure the path is correct\n", job.filePath.c_str());
+        regions[job.id] = failedRegion;
+        statuses[job.id] = TEXTURE_FAILED;
+        return;
+    }
+
+    TextureRegion region = { 0, 0.0f, 0.0f, 1.0f, 1.0f };
+    if(!job.allowAtlas || !PackIntoAtlas(job, region)) {
+        region.texture = CreateTexture(job.width, job.height, job.pixels);
+    }
+    stbi_image_free(job.pixels);
+
+    regions[job.id] = region;
+    statuses[job.id] = TEXTURE_READY;
+}
+
+bool TextureLoader::PackIntoAtlas(const Job &job, TextureRegion &region) {
+
+    int width = job.width + 2 * ATLAS_PADDING;
+    int height = job.height + 2 * ATLAS_PADDING;
+    if(job.width > ATLAS_MAX_IMAGE_SIZE || job.height > ATLAS_MAX_IMAGE_SIZE || width > pageSize || height > pageSize) {
+        return false;
+    }
+
+    //shelf packing: fill rows left to right, open a new row (or page) when one is full
+    AtlasPage *page = pages.empty() ? NULL : &pages.back();
+    if(page != NULL && page->shelfX + width > pageSize) {
+        page->shelfY += page->shelfHeight;
+        page->shelfX = 0;
+        page->shelfHeight = 0;
+    }
+    if(page == NULL || page->shelfY + height > pageSize) {
+        //zeroed so the padding really is transparent
+        std::vector<unsigned char> clear((size_t)pageSize * pageSize * 4, 0);
+        AtlasPage newPage;
+        newPage.texture = CreateTexture(pageSize, pageSize, &clear[0]);
+        newPage.shelfX = 0;
+        newPage.shelfY = 0;
+        newPage.shelfHeight = 0;
+        pages.push_back(newPage);
+        page = &pages.back();
+    }
+
+    int x = page->shelfX + ATLAS_PADDING;
+    int y = page->shelfY + ATLAS_PADDING;
+    renderState.BindTexture(page->texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, job.width, job.height, GL_RGBA, GL_UNSIGNED_BYTE, job.pixels);
+
+    page->shelfX += width;
+    page->shelfHeight = std::max(page->shelfHeight, height);
+
+    region.texture = page->texture;
+    region.u = (float)x / (float)pageSize;
+    region.v = (float)y / (float)pageSize;
+    region.width = (float)job.width / (float)pageSize;
+    region.height = (float)job.height / (float)pageSize;
+    return true;
+}
+
+GLuint TextureLoader::CreateTexture(int width, int height, const unsigned char *pixels) {
+    GLuint texture;
+    glGenTextures(1, &texture);
+    renderState.BindTexture(texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return texture;
+}
+
+bool TextureLoader::IsReady(int id) const {
+    return statuses[id] == TEXTURE_READY;
+}
+
+bool TextureLoader::AllReady() const {
+    for(int i = 0; i < (int)statuses.size(); i++) {
+        if(statuses[i] == TEXTURE_PENDING) { return false; }
+    }
+    return true;
+}
+
+TextureRegion TextureLoader::Region(int id) const {
+    return regions[id];
+}
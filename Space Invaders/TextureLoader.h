@@ -0,0 +1,110 @@
+#pragma once
+
+#ifdef _WINDOWS
+	#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// side of an atlas page, clamped to GL_MAX_TEXTURE_SIZE
+#define ATLAS_PAGE_SIZE 2048
+
+// images bigger than this on either side get a texture of their own
+#define ATLAS_MAX_IMAGE_SIZE 1024
+
+// transparent border around each packed image so linear filtering does not
+// pull in the neighbour's pixels
+#define ATLAS_PADDING 2
+
+#define TEXTURE_UPLOADS_PER_FRAME 2
+
+// Where an image ended up: a texture and the rect it covers in it, with
+// (u, v) the top left corner in texture space.
+struct TextureRegion {
+    GLuint texture;
+    float u;
+    float v;
+    float width;
+    float height;
+
+    // one cell of a uniform sprite sheet inside this region, counted left to
+    // right, top to bottom
+    TextureRegion Cell(int index, int spriteCountX, int spriteCountY) const;
+};
+
+// Decodes images on worker threads and uploads them on the GL thread, a few
+// per frame, so the first screens show up before every asset is in. Small
+// images are packed into shared atlas pages, which keeps texture binds (and
+// SpriteBatch draw calls) down.
+//
+// Until an image is uploaded its region is a transparent 1x1 texture; if it
+// fails to load the region is solid magenta and the reason is printed.
+class TextureLoader {
+    public:
+
+        TextureLoader();
+        ~TextureLoader();
+
+        // GL thread only; threadCount 0 picks one from the core count
+        void Start(int threadCount = 0);
+        void Shutdown();
+
+        // queues an image and returns its id; decoding starts right away
+        int Request(const char *filePath, bool allowAtlas = true);
+
+        // GL thread only: uploads up to maxUploads decoded images
+        void Pump(int maxUploads);
+
+        bool IsReady(int id) const;
+        bool AllReady() const;
+        TextureRegion Region(int id) const;
+
+        int PageCount() const { return (int)pages.size(); }
+
+    private:
+
+        struct Job {
+            int id;
+            std::string filePath;
+            bool allowAtlas;
+            unsigned char *pixels;
+            int width;
+            int height;
+        };
+
+        struct AtlasPage {
+            GLuint texture;
+            int shelfX;
+            int shelfY;
+            int shelfHeight;
+        };
+
+        enum TextureStatus { TEXTURE_PENDING, TEXTURE_READY, TEXTURE_FAILED };
+
+        void WorkerLoop();
+        void Upload(Job &job);
+        bool PackIntoAtlas(const Job &job, TextureRegion &region);
+        GLuint CreateTexture(int width, int height, const unsigned char *pixels);
+
+        // GL thread state
+        std::vector<TextureRegion> regions;
+        std::vector<TextureStatus> statuses;
+        std::vector<AtlasPage> pages;
+        int pageSize;
+        TextureRegion pendingRegion;
+        TextureRegion failedRegion;
+
+        // shared with the workers, guarded by lock
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque<Job> requested;
+        std::deque<Job> decoded;
+        bool stopping;
+
+        std::vector<std::thread> workers;
+};
@@ -22,129 +22,27 @@
 #include <unistd.h>
 #include <cstdlib>
 #include <ctime>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <algorithm>
+
+#include "GameState.h"
+#include "Headless.h"
+#include "SpriteBatch.h"
+#include "SpriteInstancer.h"
+#include "TextureLoader.h"
+#include "TextCache.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include "RenderState.h"
+#include "Simulation.h"
+#include "InputCheck.h"
+#include "JobSystem.h"
 
 
 SDL_Window* displayWindow;
 
-GLuint LoadTexture(const char *filePath) {
-    
-    int w,h,comp;
-    
-    unsigned char* image = stbi_load(filePath, &w, &h, &comp, STBI_rgb_alpha);
-    
-    if(image == NULL) { //check if loaded
-        std::cout << "Unable to load image. Make sure the path is correct\n";
-        assert(false); // triggers an exception; no point in continuing program
-    }
-    
-    GLuint retTexture;
-    glGenTextures(1, &retTexture);
-    glBindTexture(GL_TEXTURE_2D, retTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    
-    stbi_image_free(image);
-    return retTexture;
-}
-
-void DrawText(ShaderProgram &program, int fontTexture, std::string text, float size, float spacing) {
-    float character_size = 1.0/16.0f;
-    std::vector<float> vertexData;
-    std::vector<float> texCoordData;
-    for(int i=0; i < text.size(); i++) {
-        int spriteIndex = (int)text[i];
-        float texture_x = (float)(spriteIndex % 16) / 16.0f;
-        float texture_y = (float)(spriteIndex / 16) / 16.0f;
-        vertexData.insert(vertexData.end(), {
-            ((size+spacing) * i) + (-0.5f * size), 0.5f * size,
-            ((size+spacing) * i) + (-0.5f * size), -0.5f * size,
-            ((size+spacing) * i) + (0.5f * size), 0.5f * size,
-            ((size+spacing) * i) + (0.5f * size), -0.5f * size,
-            ((size+spacing) * i) + (0.5f * size), 0.5f * size,
-            ((size+spacing) * i) + (-0.5f * size), -0.5f * size,
-        });
-        texCoordData.insert(texCoordData.end(), {
-            texture_x, texture_y,
-            texture_x, texture_y + character_size,
-            texture_x + character_size, texture_y, //
-            texture_x + character_size, texture_y + character_size,
-            texture_x + character_size, texture_y,
-            texture_x, texture_y + character_size,
-        }); }
-    glBindTexture(GL_TEXTURE_2D, fontTexture);
-    
-    glUseProgram(program.programID);
-    
-    glVertexAttribPointer(program.texCoordAttribute, 2, GL_FLOAT, false, 0, texCoordData.data());
-    glEnableVertexAttribArray(program.texCoordAttribute);
-    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, vertexData.data());
-    glEnableVertexAttribArray(program.positionAttribute);
-    glDrawArrays(GL_TRIANGLES, 0, (int) text.size()*6);
-}
-
-class Entity {
-public:
-    
-    Entity();
-    void DrawSprite(ShaderProgram &program, int index, int spriteCountX,int spriteCountY);
-    
-    
-    glm::vec3 position;
-    glm::vec3 velocity;
-    glm::vec3 size;
-    
-    int xPos;
-    int yPos;
-    
-    float health;
-    float rotation;
-    
-    bool collision = false;
-};
-
-
-Entity::Entity () {
-    
-}
-
-
-void Entity::DrawSprite(ShaderProgram &program, int index, int spriteCountX,int spriteCountY) {
-    
-    float u = (float)(((int)index) % spriteCountX) / (float) spriteCountX;
-    float v = (float)(((int)index) / spriteCountY) / (float) spriteCountY;
-    float spriteWidth = 1.0/(float)spriteCountX;
-    float spriteHeight = 1.0/(float)spriteCountY;
-    
-    float texCoords[] = {
-        u, v+spriteHeight,
-        u+spriteWidth, v,
-        u, v,
-        u+spriteWidth, v,
-        u, v+spriteHeight,
-        u+spriteWidth, v+spriteHeight};
-    
-    float vertices[] = {-0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f, 0.5f,  -0.5f,-0.5f, 0.5f, -0.5f};
-    
-    glUseProgram(program.programID);
-    
-    glVertexAttribPointer(program.texCoordAttribute, 2, GL_FLOAT, false, 0, texCoords);
-    glEnableVertexAttribArray(program.texCoordAttribute);
-    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program.positionAttribute);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-}
-
-//class GameState {
-//public:
-//    Entity player;
-//    Entity enemies[11];
-//    Entity bullets[30];
-//    int score;
-//};
-
-
 class MainMenu {
     
     //text
@@ -156,6 +54,27 @@ public:
 
 int main(int argc, char *argv[])
 {
+    //benchmark the simulation alone: no window, no GL context
+    if(argc > 2 && strcmp(argv[1], "--headless") == 0) {
+        return RunHeadless(atoi(argv[2]), argc > 3 ? argv[3] : NULL, argc > 4 ? atoi(argv[4]) : 0);
+    }
+    //--input-check feeds scripted key transitions through the input buffer
+    if(argc > 1 && strcmp(argv[1], "--input-check") == 0) {
+        return RunInputCheck();
+    }
+    //--trace file.json [frames] records the first frames for chrome://tracing
+    if(argc > 2 && strcmp(argv[1], "--trace") == 0) {
+        profiler.StartCapture(argv[2], argc > 3 ? atoi(argv[3]) : PROFILER_CAPTURE_FRAMES);
+    }
+    //--no-instancing anywhere forces the batched sprite path, to compare the two
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--no-instancing") == 0) {
+            glRenderDevice.allowInstancing = false;
+        }
+    }
+    
+    logStart();
+    
     SDL_Init(SDL_INIT_VIDEO);
     displayWindow = SDL_CreateWindow("My Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 640, 360, SDL_WINDOW_OPENGL);
     SDL_GLContext context = SDL_GL_CreateContext(displayWindow);
@@ -172,6 +91,9 @@ int main(int argc, char *argv[])
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
+    //all drawing goes through the state cache to the real GL device
+    renderState.SetDevice(&glRenderDevice);
+    
     ShaderProgram program;
     ShaderProgram texturedProgram;
     program.Load(RESOURCE_FOLDER"vertex.glsl", RESOURCE_FOLDER"fragment.glsl");
@@ -185,245 +107,168 @@ int main(int argc, char *argv[])
     //background color
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     
-    //time keeping
-    float ticks;
-    float elapsedTime;
-    float lastFrameTicks = 0;
-    
-    GLuint LoadTexture(const char *filePath);
-    int textTexture = LoadTexture(RESOURCE_FOLDER"textsheet.png");
-    int trumpTexture = LoadTexture(RESOURCE_FOLDER"trump2.png");
-    int twitterTexture = LoadTexture(RESOURCE_FOLDER"twitterlogo.png");
+    //decoded off the main thread and packed into one atlas; the font is asked
+    //for first so the menu can show while the rest is still loading
+    TextureLoader textures;
+    textures.Start();
+    int textTexture = textures.Request(RESOURCE_FOLDER"textsheet.png");
+    int trumpTexture = textures.Request(RESOURCE_FOLDER"trump2.png");
+    int twitterTexture = textures.Request(RESOURCE_FOLDER"twitterlogo.png");
+    
+    //menu text is meshed once; the HUD counter reuses one preallocated buffer
+    TextCache textCache;
+    char hudText[32];
     // prep screens
     MainMenu mainMenu;
     
-    enum GameMode { STATE_MAIN_MENU, STATE_GAME_LEVEL};
-    GameMode mode;
-    mode = STATE_MAIN_MENU;
-    
-    //initialize player at center
-    Entity player;
-    player.xPos = 0.0f;
-    player.yPos = -4.0f;
-    
-    //create an array of enemies
-    std::vector<Entity> enemies;
-    for(int i = 0; i < 10; i++){
-        Entity enemy;
-        enemies.push_back(enemy);
-    }
-    
-    //prep bullets/flowers
-#define MAX_BULLETS 10
-    int bulletIndex = 0;
-    Entity bullets[MAX_BULLETS];
-    for(int i=0; i < MAX_BULLETS; i++) {
-//        Entity bullet;
-//        bullets[i] = bullet;
-        
-        bullets[i].xPos = player.xPos;
-    }
-    
-//    Entity enemyShots[10];
-//    for(int i= 0; i < 10; i++){
-//        Entity enemyAttack;
-//        enemyShots[i] = enemyAttack
-//    }
-//
-    bool triggerPulled = false;
-    float enemyShotX = 0;
-    float enemyShotY = 0;
-
-    
+    GameState state;
+    //seeded once per run; the headless runner uses a fixed seed instead
+    state.Seed((uint64_t)time(NULL));
+    state.LoadWaves(RESOURCE_FOLDER"waves.txt");
+    
+    //invaders, the player and enemy shots are instances of one quad; without
+    //instancing they go through a batch instead. Player shots are untextured
+    //and keep their own batch.
+    ShaderProgram instancedProgram;
+    instancedProgram.Load(RESOURCE_FOLDER"vertex_instanced.glsl", RESOURCE_FOLDER"fragment_instanced.glsl");
+    InstanceAttributes instanceAttributes = {
+        glGetAttribLocation(instancedProgram.programID, "placement"),
+        glGetAttribLocation(instancedProgram.programID, "uvRect"),
+        glGetAttribLocation(instancedProgram.programID, "tint")
+    };
+    SpriteInstancer sprites;
+    sprites.Setup(&instancedProgram, instanceAttributes, &texturedProgram);
+    LOG_INFO("sprites: %s\n", sprites.Instancing() ? "instanced" : "batched");
+    SpriteBatch spriteBatch;
+    
+    //the game runs on its own thread from here on; this one only draws snapshots
+    Simulation simulation(state);
+    simulation.inputs.Bind(SDL_SCANCODE_LEFT, ACTION_LEFT);
+    simulation.inputs.Bind(SDL_SCANCODE_RIGHT, ACTION_RIGHT);
+    simulation.inputs.Bind(SDL_SCANCODE_RETURN, ACTION_START);
+    simulation.inputs.Bind(SDL_SCANCODE_SPACE, ACTION_FIRE);
+    //shot and sprite stages fan out from the simulation thread; this thread
+    //and that one already have a core each
+    jobs.Start(std::max(0, (int)std::thread::hardware_concurrency() - 2));
+    simulation.Begin();
     
     //////////////
     SDL_Event event;
     bool done = false;
     while (!done) {
+        ProfileZone inputZone("input");
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT || event.type == SDL_WINDOWEVENT_CLOSE) {
                 done = true;
-            } else if(event.key.keysym.scancode == SDL_SCANCODE_SPACE) {
-               // if(event.key.keysym.scancode == SDL_SCANCODE_SPACE) {
-                    // DO AN ACTION WHEN SPACE IS PRESSED!
-                    triggerPulled = true;
-                //}
+            } else if(event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) {
+                //stamped with when the key moved, applied on the step it moved before
+                simulation.inputs.KeyEvent(event.key.keysym.scancode, event.type == SDL_KEYDOWN, event.key.timestamp, SDL_GetTicks());
             }
         }
+        inputZone.End();
         
-        const Uint8 *keys = SDL_GetKeyboardState(NULL);
-       
-        ticks = (float)SDL_GetTicks()/1000.0f;
-        elapsedTime = ticks - lastFrameTicks;
-        lastFrameTicks = ticks;
+        //the newest finished step; the same one again if none landed since
+        simulation.snapshots.Acquire();
+        const RenderSnapshot &snapshot = simulation.snapshots.ReadSlot();
         
-        glClear(GL_COLOR_BUFFER_BIT);
-        glUseProgram(texturedProgram.programID);
+        ProfileZone texturesZone("textures");
+        textures.Pump(TEXTURE_UPLOADS_PER_FRAME);
+        textCache.SetFont(textures.Region(textTexture));
+        texturesZone.End();
         
-        texturedProgram.SetProjectionMatrix(projectionMatrix);
-        texturedProgram.SetViewMatrix(viewMatrix);
+        ProfileZone drawZone("draw");
+        renderState.Clear();
+        renderState.UseProgram(texturedProgram);
         
-        if( mode == STATE_MAIN_MENU) {
+        renderState.SetProjectionMatrix(texturedProgram, projectionMatrix);
+        renderState.SetViewMatrix(texturedProgram, viewMatrix);
+        
+        if( snapshot.mode == STATE_MAIN_MENU) {
             
             modelMatrix = glm::mat4(1.0f);
             modelMatrix = glm::translate(modelMatrix, glm::vec3(-1.5f,0.0f,0.0f));
           
-            texturedProgram.SetModelMatrix(modelMatrix);
-            texturedProgram.SetProjectionMatrix(projectionMatrix);
-            texturedProgram.SetViewMatrix(viewMatrix);
+            renderState.SetModelMatrix(texturedProgram, modelMatrix);
+            renderState.SetProjectionMatrix(texturedProgram, projectionMatrix);
+            renderState.SetViewMatrix(texturedProgram, viewMatrix);
             
-            DrawText(texturedProgram, textTexture, "Trump (the) Invader", 0.15, 0);
+            textCache.Draw(texturedProgram, "Trump (the) Invader", 0.15, 0);
             
             modelMatrix = glm::mat4(1.0f);
             modelMatrix = glm::translate(modelMatrix, glm::vec3(-1.5f,-0.2f,0.0f));
-            texturedProgram.SetModelMatrix(modelMatrix);
+            renderState.SetModelMatrix(texturedProgram, modelMatrix);
 
-            DrawText(texturedProgram, textTexture, "Press enter to start", 0.1, 0);
-            
-            if(keys[SDL_SCANCODE_RETURN])
-            
-            {
-                mode = STATE_GAME_LEVEL;
-            }
+            textCache.Draw(texturedProgram, "Press enter to start", 0.1, 0);
         }
         
-        if (mode == STATE_GAME_LEVEL) {
-
-        glBindTexture(GL_TEXTURE_2D, trumpTexture);
+        if (snapshot.mode == STATE_GAME_LEVEL) {
 
-        //draw grid of enemies
-            // really this should be a 2D array
-        for(int i = 0; i < enemies.size(); i++){
-            if ( i > 4) { enemies[i].yPos = 1.5; }
-            if ( i > 0 ) { enemies[i].xPos = enemies[i - 1].xPos + 2.0; }
-            if ( i == 5) { enemies[i].xPos = 0;}
-            
-            modelMatrix = glm::mat4(1.0f);
-            modelMatrix = glm::scale(modelMatrix, glm::vec3(0.2f, 0.2f, 1.0f));
-            modelMatrix = glm::translate(modelMatrix, glm::vec3(-4.25 + enemies[i].xPos, 1.5 + enemies[i].yPos, 0.0f));
-            texturedProgram.SetModelMatrix(modelMatrix);
-            
-            if (enemies[i].collision == false) {
-                enemies[i].DrawSprite(texturedProgram, 1, 6, 4);
-            }
-        }
+        TextureRegion trump = textures.Region(trumpTexture);
+        TextureRegion enemySprite = trump.Cell(1, 6, 4);
+        //cell 10: the old DrawSprite(4) divided the row by spriteCountY and landed here
+        TextureRegion playerSprite = trump.Cell(10, 6, 4);
+        TextureRegion tweet = textures.Region(twitterTexture);
         
-            
-        srand((unsigned)time(0));
-        int randomNumber =  (rand()%10)+1;
-            std::cout << randomNumber << "\n";
-        for(int i = 0; i < enemies.size(); i++){
-            if ( i == randomNumber && enemies[i].collision == false) {
-                program.SetColor( 1.0f, 1.0f, 1.0f, 1.0f);
-                
-                enemyShotX = enemies[i].xPos;
-                enemyShotY -= 0.55f;
-
-                glBindTexture(GL_TEXTURE_2D, twitterTexture);
-                
+        //player bullets are plain red quads from the untextured program, enemy shots are tweets
+        renderState.SetColor(program, 1.0f, 0.0f, 0.0f, 1.0f);
+        renderState.SetProjectionMatrix(program, projectionMatrix);
+        renderState.SetViewMatrix(program, viewMatrix);
+        for(int i = 0; i < (int)snapshot.sprites.size(); i++) {
+            const SnapshotSprite &sprite = snapshot.sprites[i];
+            if(sprite.kind == SPRITE_PLAYER_SHOT) {
                 modelMatrix = glm::mat4(1.0f);
-                modelMatrix = glm::scale(modelMatrix, glm::vec3(0.04f, 0.04f, 1.0f));
-                modelMatrix = glm::translate(modelMatrix, glm::vec3(enemyShotX,enemyShotY, 0.0f));
-                
-                texturedProgram.SetModelMatrix(modelMatrix);
-
-                
-                float vertices1[] = {-0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5};
-                glVertexAttribPointer(texturedProgram.positionAttribute, 2, GL_FLOAT, false, 0, vertices1);
-                glEnableVertexAttribArray(texturedProgram.positionAttribute);
-                
-                float texCoords1[] = {0.0, 1.0, 1.0, 1.0, 1.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0.0, 0.0};
-                glVertexAttribPointer(texturedProgram.texCoordAttribute, 2, GL_FLOAT, false, 0, texCoords1);
-                glEnableVertexAttribArray(texturedProgram.texCoordAttribute);
-                
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-            }
-        
-        }
-
-        glBindTexture(GL_TEXTURE_2D, trumpTexture);
-
-        //move player
-        if(keys[SDL_SCANCODE_LEFT]) {
-            if(player.xPos > -7.7f) {
-                    player.xPos -= 1.0f;
-               // player.xPos -= elapsedTime * 5;
-
-                }
-            //player.xPos -= elapsedTime * 1.5;
-        }
-        else if(keys[SDL_SCANCODE_RIGHT]) {
-            if(player.xPos < 7.7f) {
-            player.xPos += 1.0f;
-                //player.xPos += elapsedTime * 1.5;
+                modelMatrix = glm::translate(modelMatrix, glm::vec3(sprite.x, sprite.y, 0.0f));
+                modelMatrix = glm::scale(modelMatrix, glm::vec3(sprite.size, sprite.size, 1.0f));
+                spriteBatch.Draw(program, 0, modelMatrix, 0.0f, 0.0f, 1.0f, 1.0f);
+                continue;
             }
+            const TextureRegion &region = sprite.kind == SPRITE_ENEMY ? enemySprite : sprite.kind == SPRITE_PLAYER ? playerSprite : tweet;
+            sprites.Draw(region.texture, sprite.x, sprite.y, sprite.size, sprite.size, region.u, region.v, region.width, region.height);
         }
-            
-        modelMatrix = glm::mat4(1.0f);
-        modelMatrix = glm::scale(modelMatrix, glm::vec3(0.2f, 0.2f, 1.0f));
-        modelMatrix = glm::translate(modelMatrix, glm::vec3(player.xPos, player.yPos, 0.0f));
-
-        texturedProgram.SetModelMatrix(modelMatrix);
-        texturedProgram.SetViewMatrix(viewMatrix);
-        texturedProgram.SetProjectionMatrix(projectionMatrix);
-            
-        //modelMatrix = glm::translate(modelMatrix, glm::vec3(player.xPos, player.yPos, 0.0f));
-        player.DrawSprite(texturedProgram, 4, 6, 4);
         
-    
-       // shoot bullets
-        if(triggerPulled == true) {
-
-            bullets[bulletIndex].xPos = player.xPos;
-            bullets[bulletIndex].yPos = - 23.0f;
-            bulletIndex++;
-            if(bulletIndex > MAX_BULLETS-1) {
-                bulletIndex = 0;
-            }
+        {
+            PROFILE_ZONE("sprites");
+            sprites.SetMatrices(projectionMatrix, viewMatrix);
+            sprites.Flush();
+            spriteBatch.Flush();
         }
-            
-        program.SetColor( 1.0f, 0.0f, 0.0f, 1.0f);
-
-        for(int i=0; i < MAX_BULLETS; i++) {
-           
-            bullets[i].xPos = player.xPos;
-            bullets[i].yPos += 1.0f;
-
-            modelMatrix = glm::mat4(1.0f);
-            modelMatrix = glm::scale(modelMatrix, glm::vec3(0.03f, 0.03, 1.0f));
-            modelMatrix = glm::translate(modelMatrix, glm::vec3(bullets[i].xPos, bullets[i].yPos, 1.0f));
         
-            program.SetModelMatrix(modelMatrix);
-            program.SetProjectionMatrix(projectionMatrix);
-            program.SetViewMatrix(viewMatrix);
-
-            bullets[i].DrawSprite(program, 0, 6, 4);
-
-            
-            for (int i = 0; i < enemies.size(); i++){
-                
-                float  distanceX = abs(enemies[i].xPos - bullets[i].xPos) - ((0.05 + 0.2)/4);
-                float  distanceY = abs(enemies[i].yPos - bullets[i].yPos) - ((0.05 + 0.2)/4);
-
-                if(distanceX < 0 && distanceY < 0){
-                    enemies[i].collision = true;
-                }
-            }
-            }
+        //enemies left
+        snprintf(hudText, sizeof(hudText), "Left: %d", snapshot.enemiesLeft);
+        modelMatrix = glm::mat4(1.0f);
+        modelMatrix = glm::translate(modelMatrix, glm::vec3(-1.65f, 0.9f, 0.0f));
+        renderState.SetModelMatrix(texturedProgram, modelMatrix);
+        textCache.DrawDynamic(texturedProgram, hudText, 0.08, 0);
             
         }
-            triggerPulled = false;
   
         ///////
-        glDisableVertexAttribArray(texturedProgram.positionAttribute);
-        glDisableVertexAttribArray(texturedProgram.texCoordAttribute);
-        glDisableVertexAttribArray(program.positionAttribute);
-        
+        drawZone.End();
         
+        ProfileZone swapZone("swap");
         SDL_GL_SwapWindow(displayWindow);
+        swapZone.End();
+        
+        profiler.EndFrame();
+    }
+    
+    simulation.Stop();
+    jobs.Stop();
+    InputStats inputStats = simulation.inputs.Stats();
+    if(inputStats.presses > 0) {
+        LOG_INFO("input: %llu presses, %.2f ms mean and %.2f ms worst from key to step\n",
+                 (unsigned long long)inputStats.presses, inputStats.totalLatencyNanoseconds / (inputStats.presses * 1000000.0),
+                 inputStats.worstLatencyNanoseconds / 1000000.0);
     }
+    profiler.StopCapture();
+    profiler.Report();
+    printf("render state: %llu GL calls made, %llu skipped as redundant\n", (unsigned long long)renderState.issuedCalls, (unsigned long long)renderState.skippedCalls);
     
+    textCache.Cleanup();
+    sprites.Cleanup();
+    textures.Shutdown();
     SDL_Quit();
+    logShutdown();
     return 0;
 }
 
@@ -0,0 +1,22 @@
+attribute vec4 position;
+attribute vec2 texCoord;
+
+// per sprite: center and size, uv rect (top left and size), tint
+attribute vec4 placement;
+attribute vec4 uvRect;
+attribute vec4 tint;
+
+uniform mat4 modelMatrix;
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+varying vec2 texCoordVar;
+varying vec4 tintVar;
+
+void main()
+{
+	vec4 p = vec4(placement.xy + position.xy * placement.zw, 0.0, 1.0);
+    texCoordVar = uvRect.xy + texCoord * uvRect.zw;
+    tintVar = tint;
+	gl_Position = projectionMatrix * viewMatrix * modelMatrix * p;
+}